@@ -0,0 +1,152 @@
+#include "adc_sampler.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#define ADC_CLOCK_HZ        48000000
+#define ADC_BLOCK_SAMPLES   (ADC_SAMPLER_BLOCK_FRAMES * ADC_SAMPLER_INPUTS)
+
+// Ping-pong buffers, each DMA channel owns one and triggers the other when it finishes
+static uint16_t buffers[2][ADC_BLOCK_SAMPLES];
+static int dma_channels[2] = {-1, -1};
+
+// Buffer holding the newest complete block, guarded by a sequence counter that the
+// interrupt bumps; a reader retries if it changed while it was copying
+static volatile int ready_buffer = -1;
+static volatile uint32_t block_count = 0;
+
+// Position of each input within a frame, -1 for inputs that are not sampled
+static int frame_slot(uint input) {
+    if (input > ADC_SAMPLER_TEMP || !(ADC_SAMPLER_INPUT_MASK & (1u << input))) {
+        return -1;
+    }
+    int slot = 0;
+    for (uint i = 0; i < input; i++) {
+        if (ADC_SAMPLER_INPUT_MASK & (1u << i)) {
+            slot++;
+        }
+    }
+    return slot;
+}
+
+// Runs when a buffer is full: publish it and re-arm its channel for when the other one finishes
+static void adc_sampler_dma_handler() {
+    for (int i = 0; i < 2; i++) {
+        if (!dma_channel_get_irq0_status(dma_channels[i])) {
+            continue;
+        }
+        dma_channel_acknowledge_irq0(dma_channels[i]);
+        ready_buffer = i;
+        block_count++;
+        dma_channel_set_write_addr(dma_channels[i], buffers[i], false);
+    }
+}
+
+// Configure the round robin and start the DMA
+void adc_sampler_start() {
+    // Writing AINSEL while the round robin runs would shift every later frame by a slot,
+    // so the sampler must be the only ADC owner and may only be started once
+    hard_assert(dma_channels[0] < 0);
+    adc_init();
+
+    // The IR pins are left to their drivers: GPIO27 doubles as a wheel encoder input on
+    // some builds, and converting a pin that is still a digital input does no harm
+    if (ADC_SAMPLER_INPUT_MASK & (1u << ADC_SAMPLER_VSYS)) {
+        adc_gpio_init(26 + ADC_SAMPLER_VSYS);
+    }
+    adc_set_temp_sensor_enabled(true);
+
+    // The round robin starts from the selected input and then follows the mask in
+    // ascending order, so every frame lands in the buffer in the same order
+    adc_select_input(ADC_SAMPLER_IR_LEFT);
+    adc_set_round_robin(ADC_SAMPLER_INPUT_MASK);
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_clkdiv((float)ADC_CLOCK_HZ / (ADC_SAMPLER_FRAME_RATE_HZ * ADC_SAMPLER_INPUTS) - 1.0f);
+
+    for (int i = 0; i < 2; i++) {
+        dma_channels[i] = dma_claim_unused_channel(true);
+    }
+    for (int i = 0; i < 2; i++) {
+        dma_channel_config config = dma_channel_get_default_config(dma_channels[i]);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+        channel_config_set_read_increment(&config, false);
+        channel_config_set_write_increment(&config, true);
+        channel_config_set_dreq(&config, DREQ_ADC);
+        channel_config_set_chain_to(&config, dma_channels[1 - i]);
+        dma_channel_configure(dma_channels[i], &config, buffers[i], &adc_hw->fifo, ADC_BLOCK_SAMPLES, false);
+        dma_channel_set_irq0_enabled(dma_channels[i], true);
+    }
+
+    // Shared so other drivers can use DMA_IRQ_0 as well
+    irq_add_shared_handler(DMA_IRQ_0, adc_sampler_dma_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    adc_fifo_drain();
+    dma_channel_start(dma_channels[0]);
+    adc_run(true);
+}
+
+// True once the first block has been written
+bool adc_sampler_ready() {
+    return ready_buffer >= 0;
+}
+
+// Function to read one input from the newest block, either its last sample or the block mean
+static uint16_t read_block(uint input, bool average) {
+    int slot = frame_slot(input);
+    if (slot < 0) {
+        return 0;
+    }
+
+    uint32_t sequence;
+    uint32_t value;
+    do {
+        sequence = block_count;
+        int buffer = ready_buffer;
+        if (buffer < 0) {
+            return 0;
+        }
+        const uint16_t *block = buffers[buffer];
+        if (average) {
+            value = 0;
+            for (int frame = 0; frame < ADC_SAMPLER_BLOCK_FRAMES; frame++) {
+                value += block[frame * ADC_SAMPLER_INPUTS + slot];
+            }
+            value = (value + ADC_SAMPLER_BLOCK_FRAMES / 2) / ADC_SAMPLER_BLOCK_FRAMES;
+        } else {
+            value = block[(ADC_SAMPLER_BLOCK_FRAMES - 1) * ADC_SAMPLER_INPUTS + slot];
+        }
+    } while (sequence != block_count);
+
+    return value & 0x0FFF;
+}
+
+// Newest raw sample of an input
+uint16_t adc_sampler_latest(uint input) {
+    return read_block(input, false);
+}
+
+// Mean of an input over the newest block
+uint16_t adc_sampler_average(uint input) {
+    return read_block(input, true);
+}
+
+// Voltage at an input pin
+float adc_sampler_volts(uint input) {
+    return adc_sampler_average(input) * 3.3f / (1 << 12);
+}
+
+// Die temperature in degrees C
+float adc_sampler_temperature_c() {
+    return 27.0f - (adc_sampler_volts(ADC_SAMPLER_TEMP) - 0.706f) / 0.001721f;
+}
+
+// Supply voltage on VSYS
+float adc_sampler_vsys_volts() {
+    return 3.0f * adc_sampler_volts(ADC_SAMPLER_VSYS);
+}
+
+// Number of completed blocks
+uint32_t adc_sampler_blocks() {
+    return block_count;
+}
@@ -0,0 +1,55 @@
+// adc_sampler.h
+
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include "pico/stdlib.h"
+
+// Inputs converted in round-robin order: both IR line sensors, VSYS/3 and the on-die temperature sensor
+#define ADC_SAMPLER_IR_LEFT    0  // GPIO26
+#define ADC_SAMPLER_IR_RIGHT   1  // GPIO27
+#define ADC_SAMPLER_VSYS       3  // GPIO29, VSYS through a 1/3 divider
+#define ADC_SAMPLER_TEMP       4  // On-die temperature sensor
+
+// On the Pico W GPIO29 is the wireless chip's SPI clock, so VSYS is left out of the round robin
+#ifdef PICO_CYW43_SUPPORTED
+#define ADC_SAMPLER_INPUT_MASK ((1u << ADC_SAMPLER_IR_LEFT) | (1u << ADC_SAMPLER_IR_RIGHT) | \
+                                (1u << ADC_SAMPLER_TEMP))
+#define ADC_SAMPLER_INPUTS     3  // Samples in one round-robin frame
+#else
+#define ADC_SAMPLER_INPUT_MASK ((1u << ADC_SAMPLER_IR_LEFT) | (1u << ADC_SAMPLER_IR_RIGHT) | \
+                                (1u << ADC_SAMPLER_VSYS) | (1u << ADC_SAMPLER_TEMP))
+#define ADC_SAMPLER_INPUTS     4
+#endif
+
+#define ADC_SAMPLER_FRAME_RATE_HZ 2000  // Every input is converted 2000 times a second
+#define ADC_SAMPLER_BLOCK_FRAMES  8     // Frames per DMA buffer, a new block is ready every 4 ms
+
+// Configure the ADC round robin and FIFO and start two chained DMA channels filling the
+// buffers in turn. Replaces adc_init(); nothing else may call adc_init(), adc_select_input() or
+// adc_read() afterwards, as one out-of-order conversion would misalign every later frame.
+// Callers still set up the IR pins with adc_gpio_init() when they use them.
+void adc_sampler_start();
+
+// True once the first block has been written
+bool adc_sampler_ready();
+
+// Newest raw 12-bit sample of an input, 0 before the first block or for an input not sampled
+uint16_t adc_sampler_latest(uint input);
+
+// Mean of an input over the newest block, which averages out single-conversion noise
+uint16_t adc_sampler_average(uint input);
+
+// Voltage at an input pin, from the block average
+float adc_sampler_volts(uint input);
+
+// Die temperature in degrees C, from the block average
+float adc_sampler_temperature_c();
+
+// Supply voltage on VSYS, 0 on the Pico W where it is not sampled
+float adc_sampler_vsys_volts();
+
+// Number of completed blocks, consumers can use it to tell whether new data has arrived
+uint32_t adc_sampler_blocks();
+
+#endif // ADC_SAMPLER_H
@@ -0,0 +1,44 @@
+#include "gpio_dispatch.h"
+
+typedef struct {
+    gpio_dispatch_handler_t handler;
+    void *context;
+    uint32_t event_mask;
+} GpioDispatchEntry;
+
+// Dispatch table indexed by GPIO number
+static GpioDispatchEntry dispatch_table[NUM_BANK0_GPIOS];
+
+// Shared callback installed with the SDK, forwards each event to the pin's handler
+static void gpio_dispatch_callback(uint gpio, uint32_t events) {
+    if (gpio >= NUM_BANK0_GPIOS) {
+        return;
+    }
+    GpioDispatchEntry *entry = &dispatch_table[gpio];
+    if (entry->handler != NULL) {
+        entry->handler(gpio, events, entry->context);
+    }
+}
+
+// Route edge events on a pin to its own handler
+void gpio_dispatch_register(uint gpio, uint32_t event_mask, gpio_dispatch_handler_t handler, void *context) {
+    if (gpio >= NUM_BANK0_GPIOS) {
+        return;
+    }
+    // Fill the entry before enabling the interrupt so the first edge finds a handler
+    dispatch_table[gpio].handler = handler;
+    dispatch_table[gpio].context = context;
+    dispatch_table[gpio].event_mask = event_mask;
+    gpio_set_irq_enabled_with_callback(gpio, event_mask, true, &gpio_dispatch_callback);
+}
+
+// Disable events on a pin and remove its handler
+void gpio_dispatch_unregister(uint gpio) {
+    if (gpio >= NUM_BANK0_GPIOS) {
+        return;
+    }
+    gpio_set_irq_enabled(gpio, dispatch_table[gpio].event_mask, false);
+    dispatch_table[gpio].handler = NULL;
+    dispatch_table[gpio].context = NULL;
+    dispatch_table[gpio].event_mask = 0;
+}
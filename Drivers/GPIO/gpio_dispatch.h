@@ -0,0 +1,19 @@
+// gpio_dispatch.h
+
+#ifndef GPIO_DISPATCH_H
+#define GPIO_DISPATCH_H
+
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+
+// Per-pin interrupt handler, context is the pointer given at registration
+typedef void (*gpio_dispatch_handler_t)(uint gpio, uint32_t events, void *context);
+
+// Route edge events on a pin to its own handler. The SDK only supports one GPIO
+// callback per core, so every driver registers here instead of installing its own.
+void gpio_dispatch_register(uint gpio, uint32_t event_mask, gpio_dispatch_handler_t handler, void *context);
+
+// Disable events on a pin and remove its handler
+void gpio_dispatch_unregister(uint gpio);
+
+#endif // GPIO_DISPATCH_H
@@ -0,0 +1,132 @@
+#include "ir_calibration.h"
+#include "flash_store.h"
+
+_Static_assert(sizeof(IrCalibration) <= FLASH_STORE_MAX_LENGTH, "IR calibration does not fit its flash sector");
+
+// Function to place the thresholds around the middle of the two levels
+static void set_levels(IrChannelCalibration *channel, float white, float black) {
+    float mid = 0.5f * (white + black);
+    float half_band = 0.5f * IR_CAL_HYSTERESIS * (black - white);
+    channel->white = white;
+    channel->black = black;
+    channel->low = mid - half_band;
+    channel->high = mid + half_band;
+}
+
+// Calibration matching the fixed BLACK_SURFACE_THRESHOLD
+void ir_calibration_default(IrCalibration *cal) {
+    for (int i = 0; i < IR_CAL_CHANNELS; i++) {
+        set_levels(&cal->channel[i], 200.0f, 1800.0f);
+        cal->channel[i].is_black = false;
+    }
+}
+
+// Start a new sweep
+void ir_calibration_begin(IrCalibrationSweep *sweep) {
+    sweep->count = 0;
+    for (int i = 0; i < IR_CAL_CHANNELS; i++) {
+        for (int bin = 0; bin < IR_CAL_HISTOGRAM_BINS; bin++) {
+            sweep->bins[i][bin] = 0;
+        }
+    }
+}
+
+// Add one pair of raw readings taken during the sweep
+void ir_calibration_add_sample(IrCalibrationSweep *sweep, uint16_t left_raw, uint16_t right_raw) {
+    if (sweep->count >= UINT16_MAX) {
+        return;  // Bins are 16 bits, a sweep never needs more samples than this
+    }
+    uint16_t raw[IR_CAL_CHANNELS] = {left_raw, right_raw};
+    for (int i = 0; i < IR_CAL_CHANNELS; i++) {
+        sweep->bins[i][(raw[i] & 0x0FFF) * IR_CAL_HISTOGRAM_BINS / 4096]++;
+    }
+    sweep->count++;
+}
+
+// Function to find the reading below which a given number of the sweep samples fall, at the centre of its bin
+static float percentile(const uint16_t *bins, uint32_t rank) {
+    uint32_t seen = 0;
+    for (int bin = 0; bin < IR_CAL_HISTOGRAM_BINS; bin++) {
+        seen += bins[bin];
+        if (seen > rank) {
+            return (bin + 0.5f) * 4096.0f / IR_CAL_HISTOGRAM_BINS;
+        }
+    }
+    return 4095.0f;
+}
+
+// Derive levels and thresholds from the sweep
+bool ir_calibration_finish(const IrCalibrationSweep *sweep, IrCalibration *cal) {
+    if (sweep->count < IR_CAL_MIN_SAMPLES) {
+        return false;
+    }
+
+    // Percentiles rather than the extremes, so a single spike cannot stretch the span
+    float white[IR_CAL_CHANNELS];
+    float black[IR_CAL_CHANNELS];
+    uint32_t tail = sweep->count * IR_CAL_PERCENTILE / 100;
+    for (int i = 0; i < IR_CAL_CHANNELS; i++) {
+        white[i] = percentile(sweep->bins[i], tail);
+        black[i] = percentile(sweep->bins[i], sweep->count - 1 - tail);
+        if (black[i] < white[i] + IR_CAL_MIN_SPAN) {
+            return false;
+        }
+    }
+    for (int i = 0; i < IR_CAL_CHANNELS; i++) {
+        set_levels(&cal->channel[i], white[i], black[i]);
+        cal->channel[i].is_black = false;
+    }
+    return true;
+}
+
+// Classify a reading with hysteresis and track the levels online
+bool ir_calibration_is_black(IrCalibration *cal, int channel, uint16_t raw) {
+    if (channel < 0 || channel >= IR_CAL_CHANNELS) {
+        return false;
+    }
+    IrChannelCalibration *c = &cal->channel[channel];
+    float value = raw;
+
+    // Inside the band the previous state holds, so noise on an edge cannot toggle it
+    if (value > c->high) {
+        c->is_black = true;
+    } else if (value < c->low) {
+        c->is_black = false;
+    } else {
+        return c->is_black;
+    }
+
+    // Lighting and floor changes move the levels slowly. Follow them only from readings close
+    // to a level: a sensor riding the edge of the line reads in between and would pull both
+    // levels inwards. Never let the two levels close up.
+    float white = c->white;
+    float black = c->black;
+    float track_band = IR_CAL_TRACK_BAND * (black - white);
+    if (c->is_black && value > black - track_band) {
+        black += IR_CAL_TRACK_ALPHA * (value - black);
+    } else if (!c->is_black && value < white + track_band) {
+        white += IR_CAL_TRACK_ALPHA * (value - white);
+    } else {
+        return c->is_black;
+    }
+    if (black - white >= IR_CAL_MIN_SPAN) {
+        set_levels(c, white, black);
+    }
+    return c->is_black;
+}
+
+// Persist the calibration in its reserved flash sector
+bool ir_calibration_save(const IrCalibration *cal) {
+    return flash_store_save(FLASH_STORE_IR_CAL_OFFSET, FLASH_RECORD_IR_CAL, cal, sizeof(*cal));
+}
+
+// Load the calibration from flash
+bool ir_calibration_load(IrCalibration *cal) {
+    if (!flash_store_load(FLASH_STORE_IR_CAL_OFFSET, FLASH_RECORD_IR_CAL, cal, sizeof(*cal))) {
+        return false;
+    }
+    for (int i = 0; i < IR_CAL_CHANNELS; i++) {
+        cal->channel[i].is_black = false;
+    }
+    return true;
+}
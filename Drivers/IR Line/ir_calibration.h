@@ -0,0 +1,58 @@
+// ir_calibration.h
+
+#ifndef IR_CALIBRATION_H
+#define IR_CALIBRATION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define IR_CAL_CHANNELS       2      // Left and right, indexed like LINE_FOLLOW_LEFT and LINE_FOLLOW_RIGHT
+#define IR_CAL_SWEEP_MS       3000   // Time given to sweep both sensors across the line and back
+#define IR_CAL_MIN_SAMPLES    100
+#define IR_CAL_MIN_SPAN       300    // Smallest believable gap between floor and line readings
+#define IR_CAL_HYSTERESIS     0.2f   // Width of the band around the mid level, as a fraction of the span
+#define IR_CAL_TRACK_ALPHA    0.01f  // EMA weight of each clearly classified reading when tracking levels online
+#define IR_CAL_TRACK_BAND     0.25f  // Only readings within this fraction of the span from a level move it
+#define IR_CAL_HISTOGRAM_BINS 128    // Sweep histogram over the 12-bit range, 32 counts per bin
+#define IR_CAL_PERCENTILE     2      // Levels are the 2nd and 98th percentiles, ignoring single-sample spikes
+
+typedef struct {
+    float white;       // Typical reading over the floor
+    float black;       // Typical reading over the line
+    float low;         // Falling below this switches to white
+    float high;        // Rising above this switches to black
+    bool is_black;     // Current state, only changes when a reading leaves the band
+} IrChannelCalibration;
+
+typedef struct {
+    IrChannelCalibration channel[IR_CAL_CHANNELS];
+} IrCalibration;
+
+// Histogram of each channel collected during the sweep
+typedef struct {
+    uint32_t count;
+    uint16_t bins[IR_CAL_CHANNELS][IR_CAL_HISTOGRAM_BINS];
+} IrCalibrationSweep;
+
+// Calibration matching the fixed BLACK_SURFACE_THRESHOLD, used until a sweep has been stored
+void ir_calibration_default(IrCalibration *cal);
+
+// Start a new sweep
+void ir_calibration_begin(IrCalibrationSweep *sweep);
+
+// Add one pair of raw readings taken during the sweep
+void ir_calibration_add_sample(IrCalibrationSweep *sweep, uint16_t left_raw, uint16_t right_raw);
+
+// Derive levels and thresholds, returns false if either sensor did not see both the floor and the line
+bool ir_calibration_finish(const IrCalibrationSweep *sweep, IrCalibration *cal);
+
+// Classify a reading with hysteresis and let clear readings pull the levels towards the current surface
+bool ir_calibration_is_black(IrCalibration *cal, int channel, uint16_t raw);
+
+// Persist the calibration in its reserved flash sector
+bool ir_calibration_save(const IrCalibration *cal);
+
+// Load the calibration from flash, returns false if none has been stored
+bool ir_calibration_load(IrCalibration *cal);
+
+#endif // IR_CALIBRATION_H
@@ -3,6 +3,9 @@
 #include "hardware/timer.h"
 #include <stdio.h>
 #include "pico/stdlib.h"
+#include "ir_line.h"
+#include "ir_calibration.h"
+#include "adc_sampler.h"
 
 const uint8_t LEFT_IR_SENSOR = 26;
 const uint8_t RIGHT_IR_SENSOR = 27;
@@ -19,8 +22,11 @@ const uint8_t RIGHT_ADC_CHANNEL = 1;
 
 const uint16_t BLACK_SURFACE_THRESHOLD = 1000;
 
+// Calibration used by the surface checks, the fixed threshold is used while this is NULL
+static IrCalibration *surface_calibration = NULL;
+
 void init_ir() {
-    adc_init();
+    adc_sampler_start();
     // Initialize IR sensor and power supply pins
     const uint8_t IR_SENSOR_PINS[] = {LEFT_IR_SENSOR, RIGHT_IR_SENSOR};
     const uint8_t IR_SENSOR_VCC[] = {L_VCC, R_VCC};
@@ -74,13 +80,30 @@ void init_ir() {
 //     }
 // }
 
+// Function to read the raw left ADC value, higher over a dark surface
+uint16_t ir_read_left() {
+    return adc_sampler_latest(LEFT_ADC_CHANNEL);
+}
+
+// Function to read the raw right ADC value, higher over a dark surface
+uint16_t ir_read_right() {
+    return adc_sampler_latest(RIGHT_ADC_CHANNEL);
+}
+
+// Function to classify surfaces with per-channel calibrated thresholds instead of BLACK_SURFACE_THRESHOLD
+void ir_use_calibration(IrCalibration *cal) {
+    surface_calibration = cal;
+}
+
 bool is_left_surface_black() {
 
     // Read analog values
-    adc_select_input(LEFT_ADC_CHANNEL);
-    uint16_t left_adc_result = adc_read();
+    uint16_t left_adc_result = ir_read_left();
 
     // Determine surface color based on ADC values
+    if (surface_calibration != NULL) {
+        return ir_calibration_is_black(surface_calibration, LEFT_ADC_CHANNEL, left_adc_result);
+    }
     bool left_surface_black = (left_adc_result > BLACK_SURFACE_THRESHOLD); // return 1 if black, else return 0 if white
 
     return left_surface_black;
@@ -89,15 +112,18 @@ bool is_left_surface_black() {
 bool is_right_surface_black() {
 
     // Read analog values
-    adc_select_input(RIGHT_ADC_CHANNEL);
-    uint16_t right_adc_result = adc_read();
+    uint16_t right_adc_result = ir_read_right();
 
     // Determine surface color based on ADC values
+    if (surface_calibration != NULL) {
+        return ir_calibration_is_black(surface_calibration, RIGHT_ADC_CHANNEL, right_adc_result);
+    }
     bool right_surface_black = (right_adc_result > BLACK_SURFACE_THRESHOLD); 
 
     return right_surface_black; // return 1 if black, else return 0 if white
 } 
 
+#ifndef IR_LINE_NO_MAIN
 int main(void) {
     // Initialize stdio
     stdio_init_all();
@@ -105,8 +131,40 @@ int main(void) {
     // Initialize GPIO
     init_ir();
 
+    // Use the stored thresholds, or measure new ones while both sensors are swept across the line
+    static IrCalibration cal;
+    if (ir_calibration_load(&cal)) {
+        printf("Loaded IR calibration\n");
+    } else {
+        printf("No IR calibration stored, sweep both sensors across the line for %d s\n", IR_CAL_SWEEP_MS / 1000);
+        IrCalibrationSweep sweep;
+        ir_calibration_begin(&sweep);
+        uint32_t start_ms = to_ms_since_boot(get_absolute_time());
+        while (to_ms_since_boot(get_absolute_time()) - start_ms < IR_CAL_SWEEP_MS) {
+            ir_calibration_add_sample(&sweep, ir_read_left(), ir_read_right());
+            sleep_ms(5);
+        }
+        if (ir_calibration_finish(&sweep, &cal)) {
+            ir_calibration_save(&cal);
+        } else {
+            printf("Calibration failed, a sensor did not see both the floor and the line\n");
+            ir_calibration_default(&cal);
+        }
+    }
+    for (int i = 0; i < IR_CAL_CHANNELS; i++) {
+        printf("Channel %d - White: %.0f, Black: %.0f, Thresholds: %.0f/%.0f\n", i,
+               cal.channel[i].white, cal.channel[i].black, cal.channel[i].low, cal.channel[i].high);
+    }
+    ir_use_calibration(&cal);
+
     // Start reading sensor values
     // read_lines();
+    while (true) {
+        printf("Left: %s, Right: %s\n", is_left_surface_black() ? "Black" : "White",
+               is_right_surface_black() ? "Black" : "White");
+        sleep_ms(1000);
+    }
 
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -8,6 +8,7 @@
 #include "hardware/timer.h"
 #include <stdio.h>
 #include "pico/stdlib.h"
+#include "ir_calibration.h"
 
 extern const uint8_t LEFT_IR_SENSOR;
 extern const uint8_t RIGHT_IR_SENSOR;
@@ -22,6 +23,9 @@ extern const uint8_t RIGHT_ADC_CHANNEL;
 extern const uint16_t BLACK_SURFACE_THRESHOLD;
 
 void init_ir();
+uint16_t ir_read_left();
+uint16_t ir_read_right();
+void ir_use_calibration(IrCalibration *cal);
 bool is_left_surface_black();
 bool is_right_surface_black();
 
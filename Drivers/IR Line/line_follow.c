@@ -0,0 +1,85 @@
+#include "line_follow.h"
+#include <math.h>
+
+// Function to set up the follower with the default levels
+void line_follow_init(LineFollower *follower, int mode) {
+    follower->mode = (mode < 0) ? LINE_FOLLOW_AWAY_FROM_LINE : LINE_FOLLOW_TOWARDS_LINE;
+    for (int channel = 0; channel < 2; channel++) {
+        follower->white[channel] = LINE_FOLLOW_WHITE_LEVEL;
+        follower->black[channel] = LINE_FOLLOW_BLACK_LEVEL;
+    }
+    follower->offset = 0.0f;
+    follower->previous_offset = 0.0f;
+    follower->derivative = 0.0f;
+    follower->integral = 0.0f;
+    follower->started = false;
+}
+
+// Function to set the raw readings a channel gives over the floor and over the line
+void line_follow_set_levels(LineFollower *follower, int channel, float white, float black) {
+    if (channel < 0 || channel > 1 || black <= white) {
+        return;
+    }
+    follower->white[channel] = white;
+    follower->black[channel] = black;
+}
+
+// Function to scale a raw reading to 0 over the floor and 1 over the line
+static float darkness(const LineFollower *follower, int channel, uint16_t raw) {
+    float value = ((float)raw - follower->white[channel]) / (follower->black[channel] - follower->white[channel]);
+    if (value < 0.0f) return 0.0f;
+    if (value > 1.0f) return 1.0f;
+    return value;
+}
+
+// Function to turn a pair of raw readings into the line offset
+float line_follow_offset(LineFollower *follower, uint16_t left_raw, uint16_t right_raw) {
+    float left = darkness(follower, LINE_FOLLOW_LEFT, left_raw);
+    float right = darkness(follower, LINE_FOLLOW_RIGHT, right_raw);
+
+    // Both sensors on the floor is the centred case, unless the line was last seen
+    // well off to one side: then it has run out past that sensor, so keep pulling that way
+    if (left < LINE_FOLLOW_LOST_BAND && right < LINE_FOLLOW_LOST_BAND &&
+        fabsf(follower->offset) >= LINE_FOLLOW_HOLD_OFFSET) {
+        follower->offset = (follower->offset > 0.0f) ? 1.0f : -1.0f;
+    } else {
+        follower->offset = left - right;
+    }
+    return follower->offset;
+}
+
+// Function to run one PID step on a new pair of readings
+float line_follow_update(LineFollower *follower, uint16_t left_raw, uint16_t right_raw, float dt_s) {
+    float offset = line_follow_offset(follower, left_raw, right_raw);
+    if (!follower->started || dt_s <= 0.0f) {
+        follower->started = true;
+        follower->previous_offset = offset;
+        follower->derivative = 0.0f;
+        follower->integral = 0.0f;
+        return follower->mode * LINE_FOLLOW_KP * offset;
+    }
+
+    float rate = (offset - follower->previous_offset) / dt_s;
+    follower->previous_offset = offset;
+    follower->derivative += LINE_FOLLOW_DERIVATIVE_ALPHA * (rate - follower->derivative);
+
+    float yaw = LINE_FOLLOW_KP * offset + LINE_FOLLOW_KI * follower->integral + LINE_FOLLOW_KD * follower->derivative;
+
+    // Only integrate while the output is not saturated, so a long curve does not wind it up
+    if (fabsf(yaw) < LINE_FOLLOW_MAX_YAW_RATE) {
+        follower->integral += offset * dt_s;
+        if (follower->integral > LINE_FOLLOW_INTEGRAL_LIMIT) follower->integral = LINE_FOLLOW_INTEGRAL_LIMIT;
+        if (follower->integral < -LINE_FOLLOW_INTEGRAL_LIMIT) follower->integral = -LINE_FOLLOW_INTEGRAL_LIMIT;
+    }
+
+    if (yaw > LINE_FOLLOW_MAX_YAW_RATE) yaw = LINE_FOLLOW_MAX_YAW_RATE;
+    if (yaw < -LINE_FOLLOW_MAX_YAW_RATE) yaw = -LINE_FOLLOW_MAX_YAW_RATE;
+
+    // A positive offset means the left sensor is darker; turning left moves towards it
+    return follower->mode * yaw;
+}
+
+// Function to get the forward speed for the current offset
+float line_follow_speed(const LineFollower *follower, float cruise_cm_s) {
+    return cruise_cm_s * (1.0f - LINE_FOLLOW_SLOWDOWN * fabsf(follower->offset));
+}
@@ -0,0 +1,59 @@
+// line_follow.h
+
+#ifndef LINE_FOLLOW_H
+#define LINE_FOLLOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LINE_FOLLOW_TOWARDS_LINE     1   // Line runs between the sensors: steer towards the darker side
+#define LINE_FOLLOW_AWAY_FROM_LINE  -1   // Lane between two lines: steer away from the darker side
+
+#define LINE_FOLLOW_LEFT   0   // Channel indexes, matching LEFT_ADC_CHANNEL and RIGHT_ADC_CHANNEL
+#define LINE_FOLLOW_RIGHT  1
+
+// Default raw levels, BLACK_SURFACE_THRESHOLD sits half way between them
+#define LINE_FOLLOW_WHITE_LEVEL  200.0f
+#define LINE_FOLLOW_BLACK_LEVEL  1800.0f
+
+#define LINE_FOLLOW_PERIOD_US    5000    // Steering loop runs at 200 Hz
+#define LINE_FOLLOW_LOST_BAND    0.1f    // Both sensors below this darkness see only the floor
+#define LINE_FOLLOW_HOLD_OFFSET  0.5f    // Offset beyond which the line is assumed to have left the sensors outwards
+
+// PID on the line offset, which runs from -1 (line fully under the right sensor) to 1 (under the left)
+#define LINE_FOLLOW_KP              4.0f    // rad/s of yaw per unit of offset
+#define LINE_FOLLOW_KI              1.0f    // rad/s per unit*s
+#define LINE_FOLLOW_KD              0.2f    // rad/s per unit/s
+#define LINE_FOLLOW_INTEGRAL_LIMIT  0.5f    // unit*s
+#define LINE_FOLLOW_DERIVATIVE_ALPHA 0.3f   // EMA weight of the newest offset rate
+#define LINE_FOLLOW_MAX_YAW_RATE    5.0f    // rad/s
+#define LINE_FOLLOW_SLOWDOWN        0.5f    // Fraction of cruise speed dropped at full offset
+
+typedef struct {
+    int mode;
+    float white[2];
+    float black[2];
+
+    float offset;
+    float previous_offset;
+    float derivative;
+    float integral;
+    bool started;
+} LineFollower;
+
+// Function to set up the follower with the default levels
+void line_follow_init(LineFollower *follower, int mode);
+
+// Function to set the raw readings a channel gives over the floor and over the line
+void line_follow_set_levels(LineFollower *follower, int channel, float white, float black);
+
+// Function to turn a pair of raw readings into the line offset, keeping the last side when the line is lost
+float line_follow_offset(LineFollower *follower, uint16_t left_raw, uint16_t right_raw);
+
+// Function to run one PID step on a new pair of readings and return the yaw rate, counter-clockwise positive
+float line_follow_update(LineFollower *follower, uint16_t left_raw, uint16_t right_raw, float dt_s);
+
+// Function to get the forward speed for the current offset, slowing down while the line is off centre
+float line_follow_speed(const LineFollower *follower, float cruise_cm_s);
+
+#endif // LINE_FOLLOW_H
@@ -1,4 +1,6 @@
-#include "LSM303DLHC.H"
+#include "MAGNETOMETER.H"
+#include "heading.h"
+#include <stdlib.h>
 
 // Initialize the I2C communication for the LSM303 sensor
 void custom_i2c_init(i2c_inst_t *i2c, uint8_t sda_pin, uint8_t scl_pin) {
@@ -23,6 +25,23 @@ int16_t LSM303_read_mag_data(LSM303 *lsm303, uint8_t reg) {
     return (int16_t)(buffer[0] << 8 | buffer[1]); // Combine the bytes into a single 16-bit value
 }
 
+// Read all three magnetometer axes in one transaction starting at OUT_X_H_M
+bool LSM303_read_mag_xyz(LSM303 *lsm303, LSM303Vector *mag) {
+    uint8_t reg = OUT_X_H_M;
+    uint8_t buffer[6];
+    // The magnetometer auto-increments its register pointer, so one read returns X, Z, Y (high byte first)
+    if (i2c_write_blocking(lsm303->i2c, lsm303->mag_address, &reg, 1, true) != 1) {
+        return false;
+    }
+    if (i2c_read_blocking(lsm303->i2c, lsm303->mag_address, buffer, 6, false) != 6) {
+        return false;
+    }
+    mag->x = (int16_t)(buffer[0] << 8 | buffer[1]);
+    mag->z = (int16_t)(buffer[2] << 8 | buffer[3]);
+    mag->y = (int16_t)(buffer[4] << 8 | buffer[5]);
+    return true;
+}
+
 // Configure the magnetometer with default settings
 void LSM303_enable_default(LSM303 *lsm303) {
     // Write configuration settings to magnetometer registers
@@ -53,31 +72,53 @@ int16_t LSM303_read_accel_data(LSM303 *lsm303, uint8_t reg) {
     return (int16_t)(buffer[0] | buffer[1] << 8); // Combine the bytes into a single 16-bit value
 }
 
+// Read all three accelerometer axes in one transaction starting at OUT_X_L_A
+bool LSM303_read_accel_xyz(LSM303 *lsm303, LSM303Vector *accel) {
+    uint8_t reg = OUT_X_L_A | ACCEL_AUTO_INCREMENT;
+    uint8_t buffer[6];
+    // With the auto-increment bit set one read returns X, Y, Z (low byte first)
+    if (i2c_write_blocking(lsm303->i2c, lsm303->accel_address, &reg, 1, true) != 1) {
+        return false;
+    }
+    if (i2c_read_blocking(lsm303->i2c, lsm303->accel_address, buffer, 6, false) != 6) {
+        return false;
+    }
+    accel->x = (int16_t)(buffer[0] | buffer[1] << 8);
+    accel->y = (int16_t)(buffer[2] | buffer[3] << 8);
+    accel->z = (int16_t)(buffer[4] | buffer[5] << 8);
+    return true;
+}
+
 // Calculate tilt angles based on accelerometer data
 void calculate_tilt_angles(LSM303 *lsm303) {
-    // Read accelerometer data for all three axes
-    int16_t accel_x = LSM303_read_accel_data(lsm303, OUT_X_L_A | 0x80);
-    int16_t accel_y = LSM303_read_accel_data(lsm303, OUT_Y_L_A | 0x80);
-    int16_t accel_z = LSM303_read_accel_data(lsm303, OUT_Z_L_A | 0x80);
+    // Read accelerometer data for all three axes from the same sample
+    LSM303Vector accel;
+    if (!LSM303_read_accel_xyz(lsm303, &accel)) {
+        return;
+    }
 
-    // Convert raw data to g-forces and calculate tilt angles
-    double pitch = atan2(accel_x, sqrt(accel_y * accel_y + accel_z * accel_z)) * 180.0 / M_PI;
-    double roll = atan2(accel_y, sqrt(accel_x * accel_x + accel_z * accel_z)) * 180.0 / M_PI;
+    // Fixed-point pitch and roll, no floating point needed on the RP2040
+    int32_t pitch, roll;
+    heading_tilt_angles(&accel, &pitch, &roll);
 
     // Output the calculated pitch and roll angles
-    printf("Pitch: %f degrees\n", pitch);
-    printf("Roll: %f degrees\n", roll);
+    printf("Pitch: %s%ld.%02ld degrees\n", pitch < 0 ? "-" : "", labs(pitch) / 100, labs(pitch) % 100);
+    printf("Roll: %s%ld.%02ld degrees\n", roll < 0 ? "-" : "", labs(roll) / 100, labs(roll) % 100);
 }
 
 // Detect if the device is in free-fall
 void detect_free_fall(LSM303 *lsm303) {
-    // Read accelerometer data for all three axes
-    int16_t accel_x = LSM303_read_accel_data(lsm303, OUT_X_L_A | 0x80);
-    int16_t accel_y = LSM303_read_accel_data(lsm303, OUT_Y_L_A | 0x80);
-    int16_t accel_z = LSM303_read_accel_data(lsm303, OUT_Z_L_A | 0x80);
+    // Read accelerometer data for all three axes from the same sample
+    LSM303Vector accel;
+    if (!LSM303_read_accel_xyz(lsm303, &accel)) {
+        return;
+    }
+    int16_t accel_x = accel.x;
+    int16_t accel_y = accel.y;
+    int16_t accel_z = accel.z;
 
-    // Compute the magnitude of the acceleration vector
-    double magnitude = sqrt(accel_x * accel_x + accel_y * accel_y + accel_z * accel_z);
+    // Compute the magnitude of the acceleration vector (the sum of squares fits 32 bits unsigned)
+    uint32_t magnitude = fixed_isqrt((uint32_t)(accel_x * accel_x) + (uint32_t)(accel_y * accel_y) + (uint32_t)(accel_z * accel_z));
 
     // Check if the magnitude is below a threshold that indicates free-fall
     if (magnitude < 500) {
@@ -85,7 +126,7 @@ void detect_free_fall(LSM303 *lsm303) {
     }
 }
 
-// Update the calibration data for the magnetometer: DOES NOT WORK
+// Track the min/max of each magnetometer axis (see mag_calibration.h for the full hard/soft-iron fit)
 void update_calibration_data(MagnetometerCalibrationData *calData, int16_t magX, int16_t magY, int16_t magZ) {
     // Update the min and max values for each axis based on the new readings
     if (magX < calData->minX) calData->minX = magX;
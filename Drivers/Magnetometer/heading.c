@@ -0,0 +1,165 @@
+#include "heading.h"
+#include "hardware/structs/systick.h"
+
+#define ATAN_TABLE_BITS  6                       // 64 intervals over atan(0..1)
+#define ATAN_FRAC_BITS   (16 - ATAN_TABLE_BITS)  // Interpolation bits left in a Q16 ratio
+#define ATAN_EXTRA_BITS  4                       // Table holds 1/16 centidegrees, rounded once at the end
+#define ACCEL_SHIFT      4                       // Accelerometer data is 12-bit, left-justified in 16
+
+// atan(i / 64) in 1/16 centidegrees. Linear interpolation between entries is within 0.12 centidegrees,
+// the final rounding adds 0.5 and the Q16 ratio 0.1.
+static const int32_t atan_table[(1 << ATAN_TABLE_BITS) + 1] = {
+    0, 1432, 2864, 4294, 5722, 7147, 8569, 9987,
+    11400, 12808, 14209, 15604, 16991, 18371, 19743, 21105,
+    22458, 23801, 25134, 26456, 27766, 29066, 30353, 31627,
+    32890, 34139, 35375, 36598, 37807, 39002, 40184, 41351,
+    42504, 43643, 44767, 45877, 46972, 48053, 49120, 50171,
+    51209, 52231, 53240, 54234, 55214, 56179, 57131, 58068,
+    58992, 59902, 60798, 61681, 62550, 63406, 64250, 65080,
+    65897, 66702, 67495, 68275, 69044, 69800, 70545, 71278,
+    72000,
+};
+
+// atan of a Q16 ratio in 0..1, in centidegrees
+static int32_t atan_unit_cdeg(uint32_t ratio_q16) {
+    uint32_t index = ratio_q16 >> ATAN_FRAC_BITS;
+    if (index >= (1 << ATAN_TABLE_BITS)) {
+        return 4500;
+    }
+    int32_t frac = ratio_q16 & ((1 << ATAN_FRAC_BITS) - 1);
+    int32_t step = atan_table[index + 1] - atan_table[index];
+    int32_t angle = atan_table[index] + ((step * frac) >> ATAN_FRAC_BITS);
+    return (angle + (1 << (ATAN_EXTRA_BITS - 1))) >> ATAN_EXTRA_BITS;
+}
+
+// Four-quadrant arctangent, result in -18000..18000
+int32_t fixed_atan2_cdeg(int32_t y, int32_t x) {
+    uint32_t ax = (x < 0) ? -(uint32_t)x : (uint32_t)x;
+    uint32_t ay = (y < 0) ? -(uint32_t)y : (uint32_t)y;
+    if (ax == 0 && ay == 0) {
+        return 0;
+    }
+
+    // Scale both down until the ratio fits a 32-bit division, only the ratio matters
+    while (ax > 0xFFFF || ay > 0xFFFF) {
+        ax >>= 1;
+        ay >>= 1;
+    }
+
+    // Reduce to the first octant, the RP2040 hardware divider makes the division cheap
+    int32_t angle;
+    if (ay <= ax) {
+        angle = atan_unit_cdeg((ay << 16) / ax);
+    } else {
+        angle = 9000 - atan_unit_cdeg((ax << 16) / ay);
+    }
+
+    if (x < 0) {
+        angle = 18000 - angle;
+    }
+    return (y < 0) ? -angle : angle;
+}
+
+// Integer square root, rounded down
+uint32_t fixed_isqrt(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+// Pitch and roll from an accelerometer reading
+void heading_tilt_angles(const LSM303Vector *accel, int32_t *pitch_cdeg, int32_t *roll_cdeg) {
+    int32_t ax = accel->x >> ACCEL_SHIFT;
+    int32_t ay = accel->y >> ACCEL_SHIFT;
+    int32_t az = accel->z >> ACCEL_SHIFT;
+    *pitch_cdeg = fixed_atan2_cdeg(ax, fixed_isqrt(ay * ay + az * az));
+    *roll_cdeg = fixed_atan2_cdeg(ay, fixed_isqrt(ax * ax + az * az));
+}
+
+// Heading of the X axis from magnetic north, compensated for pitch and roll
+int32_t heading_tilt_compensated(const LSM303Vector *mag, const LSM303Vector *accel) {
+    int32_t ax = accel->x >> ACCEL_SHIFT;
+    int32_t ay = accel->y >> ACCEL_SHIFT;
+    int32_t az = accel->z >> ACCEL_SHIFT;
+    int32_t mx = mag->x, my = mag->y, mz = mag->z;
+
+    // East = m x a is horizontal whatever the tilt, North = a x East completes the level frame.
+    // Projecting the X axis onto them replaces the usual sin/cos of pitch and roll.
+    int32_t ex = my * az - mz * ay;
+    int32_t ey = mz * ax - mx * az;
+    int32_t ez = mx * ay - my * ax;
+
+    // |North| = |a| * |East|, so scaling East by |a| puts both on the same footing without normalising
+    int32_t a_norm = fixed_isqrt(ax * ax + ay * ay + az * az);
+    int64_t east = (int64_t)ex * a_norm;
+    int64_t north = (int64_t)ay * ez - (int64_t)az * ey;
+
+    // Bring both back into 32 bits, only their ratio matters
+    while (east > INT32_MAX || east < -INT32_MAX || north > INT32_MAX || north < -INT32_MAX) {
+        east >>= 1;
+        north >>= 1;
+    }
+
+    int32_t heading = fixed_atan2_cdeg((int32_t)east, (int32_t)north);
+    return (heading < 0) ? heading + 36000 : heading;
+}
+
+// Cycle counter for the benchmark, SysTick counts down from 2^24 at the core clock
+static inline uint32_t cycles_now() {
+    return systick_hw->cvr;
+}
+
+// Print the cycles per call of the fixed-point routines against libm
+void heading_benchmark() {
+    const int iterations = 256;
+    volatile int32_t sink_i = 0;
+    volatile float sink_f = 0;
+
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5; // Enable, processor clock, no interrupt
+
+    // Inputs spread over all four quadrants at magnetometer scale
+    uint32_t start = cycles_now();
+    for (int i = 0; i < iterations; i++) {
+        sink_i = fixed_atan2_cdeg((i * 37) % 4096 - 2048, (i * 91) % 4096 - 2048);
+    }
+    uint32_t fixed_atan = (start - cycles_now()) & 0x00FFFFFF;
+
+    start = cycles_now();
+    for (int i = 0; i < iterations; i++) {
+        sink_f = atan2f((float)((i * 37) % 4096 - 2048), (float)((i * 91) % 4096 - 2048));
+    }
+    uint32_t libm_atan = (start - cycles_now()) & 0x00FFFFFF;
+
+    start = cycles_now();
+    for (int i = 0; i < iterations; i++) {
+        sink_i = fixed_isqrt((uint32_t)i * 48271u);
+    }
+    uint32_t fixed_sqrt = (start - cycles_now()) & 0x00FFFFFF;
+
+    start = cycles_now();
+    for (int i = 0; i < iterations; i++) {
+        sink_f = sqrtf((float)((uint32_t)i * 48271u));
+    }
+    uint32_t libm_sqrt = (start - cycles_now()) & 0x00FFFFFF;
+
+    (void)sink_i;
+    (void)sink_f;
+    printf("atan2: fixed %lu cycles, libm %lu cycles\n",
+           (unsigned long)(fixed_atan / iterations), (unsigned long)(libm_atan / iterations));
+    printf("sqrt:  fixed %lu cycles, libm %lu cycles\n",
+           (unsigned long)(fixed_sqrt / iterations), (unsigned long)(libm_sqrt / iterations));
+}
@@ -0,0 +1,27 @@
+// heading.h
+
+#ifndef HEADING_H
+#define HEADING_H
+
+#include "MAGNETOMETER.H"
+
+// Angles are in centidegrees (1/100 degree) so they fit integer arithmetic on the FPU-less RP2040.
+// fixed_atan2_cdeg is within 1 centidegree of atan2 for any input; fixed_isqrt is the exact floor.
+
+// Four-quadrant arctangent, result in -18000..18000
+int32_t fixed_atan2_cdeg(int32_t y, int32_t x);
+
+// Integer square root, rounded down
+uint32_t fixed_isqrt(uint32_t value);
+
+// Pitch and roll from an accelerometer reading
+void heading_tilt_angles(const LSM303Vector *accel, int32_t *pitch_cdeg, int32_t *roll_cdeg);
+
+// Heading of the X axis from magnetic north, compensated for pitch and roll, in 0..35999.
+// mag should already be calibrated; accel only needs to point along gravity.
+int32_t heading_tilt_compensated(const LSM303Vector *mag, const LSM303Vector *accel);
+
+// Print the cycles per call of the fixed-point routines against libm
+void heading_benchmark();
+
+#endif // HEADING_H
@@ -0,0 +1,197 @@
+#include "imu_sampler.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#define IMU_READ_BYTES 6
+
+// Which part of a sample is on the bus
+typedef enum {
+    IMU_IDLE,
+    IMU_READING_MAG,
+    IMU_READING_ACCEL,
+} ImuState;
+
+static LSM303 *imu;
+static int tx_channel = -1;
+static int rx_channel = -1;
+static struct repeating_timer sample_timer;
+
+static volatile ImuState state = IMU_IDLE;
+static volatile uint32_t transfer_start_us;
+static uint32_t commands[IMU_READ_BYTES + 1];  // Register address followed by six read commands
+static uint8_t rx_buffer[IMU_READ_BYTES];
+static ImuSample pending;                      // Sample being assembled by the DMA interrupt
+
+// Single-producer ring buffer, written from the DMA interrupt only
+static ImuSample ring[IMU_RING_SIZE];
+static volatile uint32_t ring_head = 0;
+static volatile uint32_t ring_tail = 0;
+static volatile uint32_t dropped = 0;
+
+// Copy of the newest sample guarded by a sequence counter, odd while it is being written
+static ImuSample latest;
+static volatile uint32_t latest_sequence = 0;
+
+// Queue a register read of six bytes from one device: DMA feeds the command words in and the bytes out
+static void imu_start_read(uint8_t address, uint8_t reg) {
+    i2c_hw_t *hw = i2c_get_hw(imu->i2c);
+
+    // The target address can only be changed while the block is disabled
+    hw->enable = 0;
+    hw->tar = address;
+    hw->enable = 1;
+
+    commands[0] = reg;
+    for (int i = 0; i < IMU_READ_BYTES; i++) {
+        commands[i + 1] = I2C_IC_DATA_CMD_CMD_BITS;
+    }
+    commands[1] |= I2C_IC_DATA_CMD_RESTART_BITS;
+    commands[IMU_READ_BYTES] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    dma_channel_set_write_addr(rx_channel, rx_buffer, false);
+    dma_channel_set_trans_count(rx_channel, IMU_READ_BYTES, true);
+    dma_channel_set_read_addr(tx_channel, commands, false);
+    dma_channel_set_trans_count(tx_channel, IMU_READ_BYTES + 1, true);
+}
+
+// Store a finished sample in the ring buffer and the latest copy
+static void imu_publish(const ImuSample *sample) {
+    latest_sequence++;
+    latest = *sample;
+    latest_sequence++;
+
+    uint32_t head = ring_head;
+    if (head - ring_tail >= IMU_RING_SIZE) {
+        dropped++; // Consumer is too slow, keep the older samples it has not read yet
+        return;
+    }
+    ring[head & (IMU_RING_SIZE - 1)] = *sample;
+    ring_head = head + 1;
+}
+
+// Runs when the six bytes of a read have arrived
+static void imu_dma_handler() {
+    if (!dma_channel_get_irq1_status(rx_channel)) {
+        return;
+    }
+    dma_channel_acknowledge_irq1(rx_channel);
+
+    if (state == IMU_READING_MAG) {
+        // Magnetometer registers are ordered X, Z, Y with the high byte first
+        pending.mag.x = (int16_t)(rx_buffer[0] << 8 | rx_buffer[1]);
+        pending.mag.z = (int16_t)(rx_buffer[2] << 8 | rx_buffer[3]);
+        pending.mag.y = (int16_t)(rx_buffer[4] << 8 | rx_buffer[5]);
+        state = IMU_READING_ACCEL;
+        imu_start_read(imu->accel_address, OUT_X_L_A | ACCEL_AUTO_INCREMENT);
+    } else if (state == IMU_READING_ACCEL) {
+        pending.accel.x = (int16_t)(rx_buffer[0] | rx_buffer[1] << 8);
+        pending.accel.y = (int16_t)(rx_buffer[2] | rx_buffer[3] << 8);
+        pending.accel.z = (int16_t)(rx_buffer[4] | rx_buffer[5] << 8);
+        imu_publish(&pending);
+        state = IMU_IDLE;
+    }
+}
+
+// Cancel a transfer that stalled, usually after a NACK aborted the I2C transmit FIFO
+static void imu_abort_transfer() {
+    dma_channel_abort(tx_channel);
+    dma_channel_abort(rx_channel);
+    dma_channel_acknowledge_irq1(rx_channel);
+    i2c_hw_t *hw = i2c_get_hw(imu->i2c);
+    (void)hw->clr_tx_abrt; // Reading the register clears the abort and flushes the FIFO
+    state = IMU_IDLE;
+    dropped++;
+}
+
+// Sampling timer, starts the next pair of transfers at the output data rate
+static bool imu_timer_callback(struct repeating_timer *t) {
+    uint32_t now = time_us_32();
+
+    if (state != IMU_IDLE) {
+        // Previous sample still on the bus, give it a few periods before giving up on it
+        if (now - transfer_start_us < IMU_TIMEOUT_PERIODS * (1000000 / IMU_SAMPLE_RATE_HZ)) {
+            return true;
+        }
+        imu_abort_transfer();
+    }
+
+    transfer_start_us = now;
+    pending.timestamp_us = now;
+    state = IMU_READING_MAG;
+    imu_start_read(imu->mag_address, OUT_X_H_M);
+    return true;
+}
+
+// Set the output data rates and start sampling both sensors by DMA
+bool imu_sampler_start(LSM303 *lsm303) {
+    imu = lsm303;
+
+    // Configure the sensors with blocking writes, this only happens once
+    LSM303_write_mag_reg(imu, CRA_REG_M, CRA_REG_M_ODR_75HZ);
+    LSM303_write_mag_reg(imu, CRB_REG_M, 0x20); // Set gain
+    LSM303_write_mag_reg(imu, MR_REG_M, 0x00);  // Set continuous conversion mode
+    LSM303_write_accel_reg(imu, CTRL_REG1_A, CTRL_REG1_A_ODR_100HZ);
+    LSM303_write_accel_reg(imu, CTRL_REG4_A, 0x08); // ±2g, high resolution
+
+    if (tx_channel < 0) {
+        tx_channel = dma_claim_unused_channel(true);
+        rx_channel = dma_claim_unused_channel(true);
+    }
+    i2c_hw_t *hw = i2c_get_hw(imu->i2c);
+
+    // Command words go out paced by the transmit FIFO
+    dma_channel_config tx_config = dma_channel_get_default_config(tx_channel);
+    channel_config_set_transfer_data_size(&tx_config, DMA_SIZE_32);
+    channel_config_set_read_increment(&tx_config, true);
+    channel_config_set_write_increment(&tx_config, false);
+    channel_config_set_dreq(&tx_config, i2c_get_dreq(imu->i2c, true));
+    dma_channel_configure(tx_channel, &tx_config, &hw->data_cmd, commands, 0, false);
+
+    // Received bytes come back paced by the receive FIFO
+    dma_channel_config rx_config = dma_channel_get_default_config(rx_channel);
+    channel_config_set_transfer_data_size(&rx_config, DMA_SIZE_8);
+    channel_config_set_read_increment(&rx_config, false);
+    channel_config_set_write_increment(&rx_config, true);
+    channel_config_set_dreq(&rx_config, i2c_get_dreq(imu->i2c, false));
+    dma_channel_configure(rx_channel, &rx_config, rx_buffer, &hw->data_cmd, 0, false);
+
+    // Completion of each receive runs the state machine, shared so other drivers can use DMA_IRQ_1
+    dma_channel_set_irq1_enabled(rx_channel, true);
+    irq_add_shared_handler(DMA_IRQ_1, imu_dma_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+
+    state = IMU_IDLE;
+    // Negative period keeps the start times evenly spaced regardless of callback duration
+    return add_repeating_timer_us(-(1000000 / IMU_SAMPLE_RATE_HZ), imu_timer_callback, NULL, &sample_timer);
+}
+
+// Stop the sampling timer
+void imu_sampler_stop() {
+    cancel_repeating_timer(&sample_timer);
+}
+
+// Take the oldest unread sample from the ring buffer
+bool imu_sampler_pop(ImuSample *sample) {
+    uint32_t tail = ring_tail;
+    if (tail == ring_head) {
+        return false;
+    }
+    *sample = ring[tail & (IMU_RING_SIZE - 1)];
+    ring_tail = tail + 1;
+    return true;
+}
+
+// Copy the most recent sample without consuming the ring buffer
+bool imu_sampler_latest(ImuSample *sample) {
+    uint32_t sequence;
+    do {
+        sequence = latest_sequence;
+        *sample = latest;
+    } while ((sequence & 1) || sequence != latest_sequence); // Retry if the interrupt updated it meanwhile
+    return sequence != 0;
+}
+
+// Number of samples lost to a full ring buffer, bus errors or overruns
+uint32_t imu_sampler_dropped() {
+    return dropped;
+}
@@ -0,0 +1,38 @@
+// imu_sampler.h
+
+#ifndef IMU_SAMPLER_H
+#define IMU_SAMPLER_H
+
+#include "MAGNETOMETER.H"
+
+// Output data rates written at start-up
+#define CRA_REG_M_ODR_75HZ    0x18 // Magnetometer DO bits = 110, temperature sensor off
+#define CTRL_REG1_A_ODR_100HZ 0x57 // Accelerometer 100 Hz, normal power, X/Y/Z enabled
+
+#define IMU_SAMPLE_RATE_HZ    75   // Matches the magnetometer output data rate
+#define IMU_RING_SIZE         32   // Buffered samples, must be a power of two
+#define IMU_TIMEOUT_PERIODS   3    // Periods a transfer may stay in flight before it is aborted
+
+// One timestamped sample of both sensors
+typedef struct {
+    uint32_t timestamp_us;  // Time the magnetometer transfer started
+    LSM303Vector mag;
+    LSM303Vector accel;
+} ImuSample;
+
+// Set the output data rates and start sampling both sensors by DMA at IMU_SAMPLE_RATE_HZ
+bool imu_sampler_start(LSM303 *lsm303);
+
+// Stop the sampling timer, any transfer in flight is allowed to finish
+void imu_sampler_stop();
+
+// Take the oldest unread sample from the ring buffer, returns false if it is empty
+bool imu_sampler_pop(ImuSample *sample);
+
+// Copy the most recent sample without consuming the ring buffer, returns false before the first sample
+bool imu_sampler_latest(ImuSample *sample);
+
+// Number of samples lost to a full ring buffer, bus errors or overruns
+uint32_t imu_sampler_dropped();
+
+#endif // IMU_SAMPLER_H
@@ -0,0 +1,114 @@
+#include "mag_calibration.h"
+#include "flash_store.h"
+
+#define MAG_CAL_ONE (1 << MAG_CAL_FRACTION_BITS)
+
+_Static_assert(sizeof(MagCalibration) <= FLASH_STORE_MAX_LENGTH, "magnetometer calibration does not fit its flash sector");
+
+// Calibration that leaves readings unchanged
+void mag_calibration_identity(MagCalibration *cal) {
+    for (int i = 0; i < 3; i++) {
+        cal->offset[i] = 0;
+    }
+    cal->matrix[0][0] = MAG_CAL_ONE;
+    cal->matrix[0][1] = 0;
+    cal->matrix[1][0] = 0;
+    cal->matrix[1][1] = MAG_CAL_ONE;
+    cal->z_scale = MAG_CAL_ONE;
+}
+
+// Start a new fit
+void mag_calibration_begin(MagCalibrationFit *fit) {
+    fit->count = 0;
+    for (int i = 0; i < 3; i++) {
+        fit->min[i] = INT16_MAX;
+        fit->max[i] = INT16_MIN;
+    }
+    fit->sum_x = fit->sum_y = 0;
+    fit->sum_xx = fit->sum_yy = fit->sum_xy = 0;
+}
+
+// Add one raw reading taken during the spin
+void mag_calibration_add_sample(MagCalibrationFit *fit, const LSM303Vector *mag) {
+    const int16_t axes[3] = {mag->x, mag->y, mag->z};
+    for (int i = 0; i < 3; i++) {
+        if (axes[i] < fit->min[i]) fit->min[i] = axes[i];
+        if (axes[i] > fit->max[i]) fit->max[i] = axes[i];
+    }
+    fit->count++;
+    fit->sum_x += mag->x;
+    fit->sum_y += mag->y;
+    fit->sum_xx += (int32_t)mag->x * mag->x;
+    fit->sum_yy += (int32_t)mag->y * mag->y;
+    fit->sum_xy += (int32_t)mag->x * mag->y;
+}
+
+// Fit hard-iron offsets and the soft-iron matrix
+bool mag_calibration_finish(const MagCalibrationFit *fit, MagCalibration *cal) {
+    if (fit->count < MAG_CAL_MIN_SAMPLES ||
+        fit->max[0] - fit->min[0] < MAG_CAL_MIN_SPAN ||
+        fit->max[1] - fit->min[1] < MAG_CAL_MIN_SPAN) {
+        return false;
+    }
+
+    mag_calibration_identity(cal);
+
+    // Hard iron: the centre of the swept ellipse
+    double cx = (fit->max[0] + fit->min[0]) / 2.0;
+    double cy = (fit->max[1] + fit->min[1]) / 2.0;
+    cal->offset[0] = (int16_t)(cx >= 0 ? cx + 0.5 : cx - 0.5);
+    cal->offset[1] = (int16_t)(cy >= 0 ? cy + 0.5 : cy - 0.5);
+
+    // Soft iron: covariance of the horizontal readings about the centre. For a spin at a steady rate
+    // the samples are spread evenly around the ellipse, so the covariance describes its shape.
+    double n = (double)fit->count;
+    double cxx = (fit->sum_xx - 2.0 * cx * fit->sum_x + n * cx * cx) / n;
+    double cyy = (fit->sum_yy - 2.0 * cy * fit->sum_y + n * cy * cy) / n;
+    double cxy = (fit->sum_xy - cx * fit->sum_y - cy * fit->sum_x + n * cx * cy) / n;
+    double det = cxx * cyy - cxy * cxy;
+    if (det <= 0.0) {
+        return false;
+    }
+
+    // M = det^(1/4) * C^(-1/2) turns the ellipse into a circle of the same area.
+    // For a 2x2 SPD matrix sqrt(C) = (C + s*I) / t with s = sqrt(det), t = sqrt(trace + 2s).
+    double s = sqrt(det);
+    double t = sqrt(cxx + cyy + 2.0 * s);
+    double r00 = (cxx + s) / t, r01 = cxy / t, r11 = (cyy + s) / t;
+    double root_det = r00 * r11 - r01 * r01;
+    double scale = sqrt(s) / root_det;
+
+    cal->matrix[0][0] = (int32_t)(r11 * scale * MAG_CAL_ONE + 0.5);
+    cal->matrix[0][1] = (int32_t)(-r01 * scale * MAG_CAL_ONE + (r01 > 0 ? -0.5 : 0.5));
+    cal->matrix[1][0] = cal->matrix[0][1];
+    cal->matrix[1][1] = (int32_t)(r00 * scale * MAG_CAL_ONE + 0.5);
+
+    // A spin in place barely moves Z; only trust its offset and scale if it swept a similar range
+    double radius = sqrt(2.0 * s);
+    int z_span = fit->max[2] - fit->min[2];
+    if (z_span > radius) {
+        cal->offset[2] = (int16_t)((fit->max[2] + fit->min[2]) / 2);
+        cal->z_scale = (int32_t)(2.0 * radius / z_span * MAG_CAL_ONE + 0.5);
+    }
+    return true;
+}
+
+// Apply the calibration using integer arithmetic only
+void mag_calibration_apply(const MagCalibration *cal, const LSM303Vector *raw, LSM303Vector *corrected) {
+    int32_t dx = raw->x - cal->offset[0];
+    int32_t dy = raw->y - cal->offset[1];
+    int32_t dz = raw->z - cal->offset[2];
+    corrected->x = (int16_t)((cal->matrix[0][0] * dx + cal->matrix[0][1] * dy) >> MAG_CAL_FRACTION_BITS);
+    corrected->y = (int16_t)((cal->matrix[1][0] * dx + cal->matrix[1][1] * dy) >> MAG_CAL_FRACTION_BITS);
+    corrected->z = (int16_t)((cal->z_scale * dz) >> MAG_CAL_FRACTION_BITS);
+}
+
+// Persist the calibration in its reserved flash sector
+bool mag_calibration_save(const MagCalibration *cal) {
+    return flash_store_save(FLASH_STORE_MAG_CAL_OFFSET, FLASH_RECORD_MAG_CAL, cal, sizeof(*cal));
+}
+
+// Load the calibration from flash
+bool mag_calibration_load(MagCalibration *cal) {
+    return flash_store_load(FLASH_STORE_MAG_CAL_OFFSET, FLASH_RECORD_MAG_CAL, cal, sizeof(*cal));
+}
@@ -0,0 +1,49 @@
+// mag_calibration.h
+
+#ifndef MAG_CALIBRATION_H
+#define MAG_CALIBRATION_H
+
+#include "MAGNETOMETER.H"
+
+#define MAG_CAL_FRACTION_BITS 14  // Fixed-point format of the correction coefficients (Q14)
+#define MAG_CAL_MIN_SAMPLES   150 // Two turns at 75 Hz need well over this
+#define MAG_CAL_MIN_SPAN      100 // Smallest believable peak-to-peak swing on X and Y during a spin
+
+// Correction applied to every raw reading: corrected = M * (raw - offset)
+typedef struct {
+    int16_t offset[3];    // Hard-iron offset for X, Y, Z
+    int32_t matrix[2][2]; // Soft-iron correction for the horizontal axes, Q14
+    int32_t z_scale;      // Scale for Z, Q14
+} MagCalibration;
+
+// Sums collected while the robot spins in place
+typedef struct {
+    uint32_t count;
+    int16_t min[3];
+    int16_t max[3];
+    int64_t sum_x, sum_y;
+    int64_t sum_xx, sum_yy, sum_xy;
+} MagCalibrationFit;
+
+// Calibration that leaves readings unchanged
+void mag_calibration_identity(MagCalibration *cal);
+
+// Start a new fit
+void mag_calibration_begin(MagCalibrationFit *fit);
+
+// Add one raw reading taken during the spin
+void mag_calibration_add_sample(MagCalibrationFit *fit, const LSM303Vector *mag);
+
+// Fit hard-iron offsets and the soft-iron matrix, returns false if the spin did not cover enough of the circle
+bool mag_calibration_finish(const MagCalibrationFit *fit, MagCalibration *cal);
+
+// Apply the calibration using integer arithmetic only
+void mag_calibration_apply(const MagCalibration *cal, const LSM303Vector *raw, LSM303Vector *corrected);
+
+// Persist the calibration in its reserved flash sector
+bool mag_calibration_save(const MagCalibration *cal);
+
+// Load the calibration from flash, returns false if none has been stored
+bool mag_calibration_load(MagCalibration *cal);
+
+#endif // MAG_CALIBRATION_H
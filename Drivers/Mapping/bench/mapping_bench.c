@@ -0,0 +1,305 @@
+// mapping_bench.c
+//
+// Host benchmark for the map representations: linked-list struct Graph from
+// mapping.c against CsrGraph. Generates synthetic mazes and sparse random
+// graphs from 16 to 100k vertices and times construction, BFS, DFS and
+// shortest path on both layouts.
+//
+// Build and run on the host from Drivers/Mapping:
+//   cc -O2 -DMAPPING_NO_MAIN -I. bench/mapping_bench.c mapping.c csr_graph.c grid_map.c -o mapping_bench
+//   ./mapping_bench
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "mapping.h"
+#include "csr_graph.h"
+
+#define MIN_BENCH_NS 50000000LL  // Repeat each measurement for at least 50 ms
+#define MALLOC_OVERHEAD 16        // Typical per-allocation bookkeeping of a host malloc
+
+// Edge list a benchmark graph is generated into
+typedef struct {
+  int vertex_count;
+  int edge_count;
+  int* src;
+  int* dest;
+} EdgeList;
+
+static uint32_t rng_state = 12345;
+
+// Function to get a pseudo-random number (xorshift32), repeatable between runs
+static uint32_t next_random() {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static int64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void add_edge(EdgeList* list, int a, int b) {
+  list->src[list->edge_count] = a;
+  list->dest[list->edge_count] = b;
+  list->edge_count++;
+}
+
+// Function to generate a width x height maze: a random spanning tree carved by
+// iterative DFS, plus a few extra openings so there are loops like on a real course
+static void generate_maze(EdgeList* list, int width, int height) {
+  int n = width * height;
+  list->vertex_count = n;
+  list->edge_count = 0;
+  list->src = malloc(2 * n * sizeof(int));
+  list->dest = malloc(2 * n * sizeof(int));
+
+  uint8_t* visited = calloc(n, 1);
+  int* stack = malloc(n * sizeof(int));
+  int top = 0;
+  stack[top++] = 0;
+  visited[0] = 1;
+
+  while (top > 0) {
+    int cell = stack[top - 1];
+    int x = cell % width;
+    int y = cell / width;
+    int options[4];
+    int count = 0;
+    if (y + 1 < height && !visited[cell + width]) options[count++] = cell + width;
+    if (x + 1 < width && !visited[cell + 1]) options[count++] = cell + 1;
+    if (y > 0 && !visited[cell - width]) options[count++] = cell - width;
+    if (x > 0 && !visited[cell - 1]) options[count++] = cell - 1;
+
+    if (count == 0) {
+      top--;
+      continue;
+    }
+    int next = options[next_random() % count];
+    visited[next] = 1;
+    add_edge(list, cell, next);
+    stack[top++] = next;
+  }
+
+  for (int i = 0; i < n / 20; i++) {
+    int cell = next_random() % n;
+    if (cell % width + 1 < width) {
+      add_edge(list, cell, cell + 1);
+    }
+  }
+
+  free(visited);
+  free(stack);
+}
+
+// Function to generate a connected sparse graph: a ring plus one random chord per vertex
+static void generate_sparse(EdgeList* list, int n) {
+  list->vertex_count = n;
+  list->edge_count = 0;
+  list->src = malloc(2 * n * sizeof(int));
+  list->dest = malloc(2 * n * sizeof(int));
+
+  for (int v = 0; v < n; v++) {
+    add_edge(list, v, (v + 1) % n);
+    add_edge(list, v, next_random() % n);
+  }
+}
+
+// Function to release a struct Graph, mapping.c has no destructor of its own
+static void free_list_graph(struct Graph* graph) {
+  for (int v = 0; v < graph->numVertices; v++) {
+    struct node* temp = graph->adjLists[v];
+    while (temp) {
+      struct node* next = temp->next;
+      free(temp);
+      temp = next;
+    }
+  }
+  free(graph->adjLists);
+  free(graph->visited);
+  free(graph);
+}
+
+static struct Graph* build_lists(const EdgeList* list) {
+  struct Graph* graph = createGraph(list->vertex_count);
+  for (int i = 0; i < list->edge_count; i++) {
+    addEdge(graph, list->src[i], list->dest[i]);
+  }
+  return graph;
+}
+
+// Traversals over the linked lists. These mirror bfs and DFS in mapping.c but without
+// their printing, the fixed 40-entry queue and the recursion, so only the layout differs.
+static int list_bfs(const struct Graph* graph, int start, int* parent, int* queue) {
+  for (int v = 0; v < graph->numVertices; v++) {
+    parent[v] = -1;
+  }
+  int head = 0;
+  int tail = 0;
+  parent[start] = start;
+  queue[tail++] = start;
+
+  while (head < tail) {
+    int current = queue[head++];
+    for (struct node* temp = graph->adjLists[current]; temp; temp = temp->next) {
+      if (parent[temp->vertex] == -1) {
+        parent[temp->vertex] = current;
+        queue[tail++] = temp->vertex;
+      }
+    }
+  }
+  return tail;
+}
+
+static int list_dfs(const struct Graph* graph, int start, uint8_t* visited, int* stack) {
+  memset(visited, 0, graph->numVertices);
+  int top = 0;
+  int count = 0;
+  stack[top++] = start;
+
+  while (top > 0) {
+    int current = stack[--top];
+    if (visited[current]) {
+      continue;
+    }
+    visited[current] = 1;
+    count++;
+    for (struct node* temp = graph->adjLists[current]; temp; temp = temp->next) {
+      if (!visited[temp->vertex]) {
+        stack[top++] = temp->vertex;
+      }
+    }
+  }
+  return count;
+}
+
+static int list_shortest_path(const struct Graph* graph, int start, int goal, int* parent, int* queue, int* path) {
+  list_bfs(graph, start, parent, queue);
+  if (parent[goal] == -1) {
+    return 0;
+  }
+  int length = 0;
+  for (int v = goal; v != start; v = parent[v]) {
+    path[length++] = v;
+  }
+  path[length++] = start;
+  return length;
+}
+
+// Workspaces shared by all traversals of one graph
+typedef struct {
+  int* parent;
+  int* queue;
+  int* stack;
+  int* path;
+  uint8_t* visited;
+} Workspace;
+
+// Function to time one operation, repeating it until the total is long enough to measure
+#define TIME_OP(result_ns, op)                   \
+  do {                                           \
+    int64_t start_ns = now_ns();                 \
+    int64_t elapsed_ns = 0;                      \
+    long runs = 0;                               \
+    do {                                         \
+      op;                                        \
+      runs++;                                    \
+      elapsed_ns = now_ns() - start_ns;          \
+    } while (elapsed_ns < MIN_BENCH_NS);         \
+    (result_ns) = (double)elapsed_ns / runs;     \
+  } while (0)
+
+static volatile int sink;
+
+static void bench_graph(const char* name, const EdgeList* list) {
+  int n = list->vertex_count;
+  int goal = n - 1;
+  Workspace ws = {
+    .parent = malloc(n * sizeof(int)),
+    .queue = malloc(n * sizeof(int)),
+    .stack = malloc((2 * list->edge_count + 1) * sizeof(int)),
+    .path = malloc(n * sizeof(int)),
+    .visited = malloc(n)
+  };
+  double build_list_ns, build_csr_ns, bfs_list_ns, bfs_csr_ns, dfs_list_ns, dfs_csr_ns, sp_list_ns, sp_csr_ns;
+
+  TIME_OP(build_list_ns, free_list_graph(build_lists(list)));
+  TIME_OP(build_csr_ns, {
+    CsrGraph g;
+    csr_graph_from_edges(&g, n, list->src, list->dest, list->edge_count, true);
+    csr_graph_free(&g);
+  });
+
+  struct Graph* lists = build_lists(list);
+  CsrGraph csr;
+  csr_graph_from_edges(&csr, n, list->src, list->dest, list->edge_count, true);
+
+  TIME_OP(bfs_list_ns, sink = list_bfs(lists, 0, ws.parent, ws.queue));
+  TIME_OP(bfs_csr_ns, sink = csr_graph_bfs(&csr, 0, ws.parent, ws.queue));
+  TIME_OP(dfs_list_ns, sink = list_dfs(lists, 0, ws.visited, ws.stack));
+  TIME_OP(dfs_csr_ns, sink = csr_graph_dfs(&csr, 0, ws.visited, ws.stack));
+  TIME_OP(sp_list_ns, sink = list_shortest_path(lists, 0, goal, ws.parent, ws.queue, ws.path));
+  TIME_OP(sp_csr_ns, sink = csr_graph_shortest_path(&csr, 0, goal, ws.parent, ws.queue, ws.path));
+
+  // Both layouts must agree before their timings mean anything
+  int reached_list = list_bfs(lists, 0, ws.parent, ws.queue);
+  int reached_csr = csr_graph_bfs(&csr, 0, ws.parent, ws.queue);
+  int path_list = list_shortest_path(lists, 0, goal, ws.parent, ws.queue, ws.path);
+  int path_csr = csr_graph_shortest_path(&csr, 0, goal, ws.parent, ws.queue, ws.path);
+  if (reached_list != reached_csr || path_list != path_csr) {
+    printf("MISMATCH on %s %d: reached %d/%d, path %d/%d\n", name, n, reached_list, reached_csr, path_list, path_csr);
+  }
+
+  size_t list_bytes = n * (sizeof(struct node*) + sizeof(int)) +
+                      2 * list->edge_count * (sizeof(struct node) + MALLOC_OVERHEAD);
+  size_t csr_bytes = (n + 1 + 2 * list->edge_count) * sizeof(int);
+
+  printf("%-6s %7d %8d | %9.1f %9.1f | %9.1f %9.1f | %9.1f %9.1f | %9.1f %9.1f | %9zu %9zu\n",
+         name, n, list->edge_count,
+         build_list_ns / 1000.0, build_csr_ns / 1000.0,
+         bfs_list_ns / 1000.0, bfs_csr_ns / 1000.0,
+         dfs_list_ns / 1000.0, dfs_csr_ns / 1000.0,
+         sp_list_ns / 1000.0, sp_csr_ns / 1000.0,
+         list_bytes, csr_bytes);
+
+  free_list_graph(lists);
+  csr_graph_free(&csr);
+  free(ws.parent);
+  free(ws.queue);
+  free(ws.stack);
+  free(ws.path);
+  free(ws.visited);
+}
+
+int main() {
+  static const int sizes[] = {16, 256, 4096, 65536, 100000};
+
+  printf("Times in microseconds per operation, list = linked-list struct Graph, csr = CsrGraph\n");
+  printf("%-6s %7s %8s | %9s %9s | %9s %9s | %9s %9s | %9s %9s | %9s %9s\n",
+         "graph", "verts", "edges", "build lst", "build csr", "bfs lst", "bfs csr",
+         "dfs lst", "dfs csr", "path lst", "path csr", "bytes lst", "bytes csr");
+
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    EdgeList list;
+    int side = 1;
+    while ((side + 1) * (side + 1) <= sizes[i]) {
+      side++;
+    }
+    generate_maze(&list, side, side);
+    bench_graph("maze", &list);
+    free(list.src);
+    free(list.dest);
+
+    generate_sparse(&list, sizes[i]);
+    bench_graph("sparse", &list);
+    free(list.src);
+    free(list.dest);
+  }
+
+  return 0;
+}
@@ -0,0 +1,183 @@
+#include <stdlib.h>
+#include <string.h>
+#include "csr_graph.h"
+
+// Function to allocate the arrays of a graph
+static bool allocate(CsrGraph* graph, int vertex_count, int edge_count) {
+  graph->vertex_count = vertex_count;
+  graph->edge_count = edge_count;
+  graph->offsets = calloc(vertex_count + 1, sizeof(int));
+  graph->targets = malloc((edge_count > 0 ? edge_count : 1) * sizeof(int));
+  if (graph->offsets == NULL || graph->targets == NULL) {
+    csr_graph_free(graph);
+    return false;
+  }
+  return true;
+}
+
+// Function to build a graph from an edge list, a counting sort on the source vertex
+bool csr_graph_from_edges(CsrGraph* graph, int vertex_count, const int* src, const int* dest,
+                          int edge_count, bool undirected) {
+  if (!allocate(graph, vertex_count, undirected ? 2 * edge_count : edge_count)) {
+    return false;
+  }
+
+  // Count the out-degree of every vertex, then turn the counts into start offsets
+  for (int i = 0; i < edge_count; i++) {
+    graph->offsets[src[i] + 1]++;
+    if (undirected) {
+      graph->offsets[dest[i] + 1]++;
+    }
+  }
+  for (int v = 0; v < vertex_count; v++) {
+    graph->offsets[v + 1] += graph->offsets[v];
+  }
+
+  // Place each edge at the next free slot of its source, offsets[v] is used as the cursor
+  for (int i = 0; i < edge_count; i++) {
+    graph->targets[graph->offsets[src[i]]++] = dest[i];
+    if (undirected) {
+      graph->targets[graph->offsets[dest[i]]++] = src[i];
+    }
+  }
+
+  // The cursors now sit at the start of the next vertex, shift them back
+  memmove(graph->offsets + 1, graph->offsets, vertex_count * sizeof(int));
+  graph->offsets[0] = 0;
+  return true;
+}
+
+// Function to build a graph from the linked-list adjacency in struct Graph
+bool csr_graph_from_lists(CsrGraph* graph, const struct Graph* lists) {
+  int edge_count = 0;
+  for (int v = 0; v < lists->numVertices; v++) {
+    for (struct node* temp = lists->adjLists[v]; temp; temp = temp->next) {
+      edge_count++;
+    }
+  }
+
+  if (!allocate(graph, lists->numVertices, edge_count)) {
+    return false;
+  }
+
+  int next = 0;
+  for (int v = 0; v < lists->numVertices; v++) {
+    graph->offsets[v] = next;
+    for (struct node* temp = lists->adjLists[v]; temp; temp = temp->next) {
+      graph->targets[next++] = temp->vertex;
+    }
+  }
+  graph->offsets[lists->numVertices] = next;
+  return true;
+}
+
+// Function to build a graph from the open sides of a grid map
+bool csr_graph_from_grid(CsrGraph* graph, const GridMap* map) {
+  int edge_count = 0;
+  for (GridCell cell = 0; cell < GRID_MAP_CELLS; cell++) {
+    uint8_t open = grid_map_open_mask(map, cell);
+    for (int dir = GRID_NORTH; dir <= GRID_WEST; dir++) {
+      if ((open & GRID_WALL(dir)) && grid_neighbour(cell, dir) != GRID_CELL_NONE) {
+        edge_count++;
+      }
+    }
+  }
+
+  if (!allocate(graph, GRID_MAP_CELLS, edge_count)) {
+    return false;
+  }
+
+  int next = 0;
+  for (GridCell cell = 0; cell < GRID_MAP_CELLS; cell++) {
+    graph->offsets[cell] = next;
+    uint8_t open = grid_map_open_mask(map, cell);
+    for (int dir = GRID_NORTH; dir <= GRID_WEST; dir++) {
+      GridCell neighbour = grid_neighbour(cell, dir);
+      if ((open & GRID_WALL(dir)) && neighbour != GRID_CELL_NONE) {
+        graph->targets[next++] = neighbour;
+      }
+    }
+  }
+  graph->offsets[GRID_MAP_CELLS] = next;
+  return true;
+}
+
+// Function to release the arrays of a graph
+void csr_graph_free(CsrGraph* graph) {
+  free(graph->offsets);
+  free(graph->targets);
+  graph->offsets = NULL;
+  graph->targets = NULL;
+}
+
+// Function to run BFS from start
+int csr_graph_bfs(const CsrGraph* graph, int start, int* parent, int* queue) {
+  for (int v = 0; v < graph->vertex_count; v++) {
+    parent[v] = -1;
+  }
+
+  // Every vertex enters the queue once, so a plain array with two indices is enough
+  int head = 0;
+  int tail = 0;
+  parent[start] = start;
+  queue[tail++] = start;
+
+  while (head < tail) {
+    int current = queue[head++];
+    for (int e = graph->offsets[current]; e < graph->offsets[current + 1]; e++) {
+      int next = graph->targets[e];
+      if (parent[next] == -1) {
+        parent[next] = current;
+        queue[tail++] = next;
+      }
+    }
+  }
+  return tail;
+}
+
+// Function to run an iterative DFS from start
+int csr_graph_dfs(const CsrGraph* graph, int start, uint8_t* visited, int* stack) {
+  memset(visited, 0, graph->vertex_count);
+
+  // A vertex can be pushed once per incoming edge, which bounds the stack
+  int top = 0;
+  int count = 0;
+  stack[top++] = start;
+
+  while (top > 0) {
+    int current = stack[--top];
+    if (visited[current]) {
+      continue;
+    }
+    visited[current] = 1;
+    count++;
+
+    for (int e = graph->offsets[current + 1] - 1; e >= graph->offsets[current]; e--) {
+      if (!visited[graph->targets[e]]) {
+        stack[top++] = graph->targets[e];
+      }
+    }
+  }
+  return count;
+}
+
+// Function to find a shortest path from start to goal
+int csr_graph_shortest_path(const CsrGraph* graph, int start, int goal, int* parent, int* queue, int* path) {
+  csr_graph_bfs(graph, start, parent, queue);
+  if (parent[goal] == -1) {
+    return 0;
+  }
+
+  int length = 1;
+  for (int v = goal; v != start; v = parent[v]) {
+    length++;
+  }
+  int index = length;
+  for (int v = goal; ; v = parent[v]) {
+    path[--index] = v;
+    if (v == start) {
+      break;
+    }
+  }
+  return length;
+}
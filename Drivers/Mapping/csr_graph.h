@@ -0,0 +1,47 @@
+// csr_graph.h
+
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "mapping.h"
+#include "grid_map.h"
+
+// Compressed sparse row graph: the neighbours of vertex v are
+// targets[offsets[v]] .. targets[offsets[v + 1] - 1], all in one array.
+// Built once from any adjacency source, then only read.
+typedef struct {
+  int vertex_count;
+  int edge_count;   // Directed edges, an undirected edge counts twice
+  int* offsets;     // vertex_count + 1 entries
+  int* targets;     // edge_count entries
+} CsrGraph;
+
+// Function to build a graph from an edge list, adding both directions when undirected is set
+bool csr_graph_from_edges(CsrGraph* graph, int vertex_count, const int* src, const int* dest,
+                          int edge_count, bool undirected);
+
+// Function to build a graph from the linked-list adjacency in struct Graph
+bool csr_graph_from_lists(CsrGraph* graph, const struct Graph* lists);
+
+// Function to build a graph from the open sides of a grid map, vertex numbers are cell indices
+bool csr_graph_from_grid(CsrGraph* graph, const GridMap* map);
+
+// Function to release the arrays of a graph
+void csr_graph_free(CsrGraph* graph);
+
+// Function to run BFS from start. parent and queue need vertex_count entries each;
+// parent[v] is -1 for vertices that were not reached. Returns the number reached.
+int csr_graph_bfs(const CsrGraph* graph, int start, int* parent, int* queue);
+
+// Function to run an iterative DFS from start. visited needs vertex_count bytes,
+// stack needs edge_count + 1 entries. Returns the number of vertices visited.
+int csr_graph_dfs(const CsrGraph* graph, int start, uint8_t* visited, int* stack);
+
+// Function to find a shortest path, written to path from start to goal.
+// Workspaces as for csr_graph_bfs, path needs vertex_count entries.
+// Returns the number of vertices on the path, 0 if goal cannot be reached.
+int csr_graph_shortest_path(const CsrGraph* graph, int start, int goal, int* parent, int* queue, int* path);
+
+#endif // CSR_GRAPH_H
@@ -0,0 +1,105 @@
+#include "explorer.h"
+
+// Function to start exploring from a cell, facing a direction
+void explorer_init(Explorer* explorer, GridMap* map, GridCell start, int heading) {
+  explorer->map = map;
+  explorer->depth = 0;
+  explorer->position = start;
+  explorer->heading = heading & 3;
+  explorer->route.length = 0;
+  explorer->route_index = 0;
+}
+
+// Function to convert walls seen relative to the robot into a wall mask for the map.
+// The cell behind is where the robot came from, so it is open except at the start,
+// where the caller can add the back wall itself.
+uint8_t explorer_walls_from_sensors(int heading, bool front, bool right, bool left) {
+  uint8_t walls = 0;
+  if (front) walls |= GRID_WALL(heading & 3);
+  if (right) walls |= GRID_WALL((heading + 1) & 3);
+  if (left) walls |= GRID_WALL((heading + 3) & 3);
+  return walls;
+}
+
+// Function to find an open, unvisited neighbour, trying straight on first, then right, left and back
+static int unvisited_direction(const Explorer* explorer, GridCell cell, int heading) {
+  static const int order[] = {0, 1, 3, 2};
+  uint8_t open = grid_map_open_mask(explorer->map, cell);
+
+  for (int i = 0; i < 4; i++) {
+    int dir = (heading + order[i]) & 3;
+    if (!(open & GRID_WALL(dir))) {
+      continue;
+    }
+    GridCell next = grid_neighbour(cell, dir);
+    if (next != GRID_CELL_NONE && !grid_map_is_visited(explorer->map, next)) {
+      return dir;
+    }
+  }
+  return EXPLORER_DONE;
+}
+
+// Function to find the direction from a cell to an adjacent one
+static int direction_to(GridCell from, GridCell to) {
+  for (int dir = GRID_NORTH; dir <= GRID_WEST; dir++) {
+    if (grid_neighbour(from, dir) == to) {
+      return dir;
+    }
+  }
+  return EXPLORER_DONE;
+}
+
+// Function to commit to a move and update the explorer's idea of where it is
+static int move(Explorer* explorer, int dir) {
+  explorer->position = grid_neighbour(explorer->position, dir);
+  explorer->heading = dir;
+  return dir;
+}
+
+// Function to record the walls of the current cell and choose the next move
+int explorer_step(Explorer* explorer, uint8_t walls) {
+  GridMap* map = explorer->map;
+  GridCell here = explorer->position;
+
+  // New cell: record it and put it on the stack. Any backtracking route is dropped,
+  // the robot is in new territory now.
+  if (!grid_map_is_visited(map, here)) {
+    grid_map_observe(map, here, walls);
+    explorer->stack[explorer->depth++] = here;
+    explorer->route.length = 0;
+  }
+
+  // Keep following the route back to the last cell with unvisited neighbours
+  if (explorer->route_index < explorer->route.length) {
+    GridCell next = explorer->route.cells[explorer->route_index++];
+    int dir = direction_to(here, next);
+    if (dir != EXPLORER_DONE && !grid_map_has_wall(map, here, dir)) {
+      return move(explorer, dir);
+    }
+    explorer->route.length = 0;
+  }
+
+  // Go deeper if there is an unvisited cell next to this one
+  int dir = unvisited_direction(explorer, here, explorer->heading);
+  if (dir != EXPLORER_DONE) {
+    return move(explorer, dir);
+  }
+
+  // Dead end: drop stack entries with nothing left to visit
+  while (explorer->depth > 0 &&
+         unvisited_direction(explorer, explorer->stack[explorer->depth - 1], explorer->heading) == EXPLORER_DONE) {
+    explorer->depth--;
+  }
+  if (explorer->depth == 0) {
+    return EXPLORER_DONE;
+  }
+
+  // Backtrack along the shortest known path instead of retracing every step
+  GridCell target = explorer->stack[explorer->depth - 1];
+  if (!path_planner_shortest(&explorer->planner, map, here, target, &explorer->route) ||
+      explorer->route.length < 2) {
+    return EXPLORER_DONE;
+  }
+  explorer->route_index = 2;
+  return move(explorer, direction_to(here, explorer->route.cells[1]));
+}
@@ -0,0 +1,36 @@
+// explorer.h
+
+#ifndef EXPLORER_H
+#define EXPLORER_H
+
+#include "grid_map.h"
+#include "path_planner.h"
+
+#define EXPLORER_DONE -1
+
+// Depth-first maze exploration with an explicit stack, so the call depth stays
+// constant however large the maze is. Declare it static: it holds a planner
+// and is too big for a 256-word task stack.
+typedef struct {
+  GridMap* map;
+  PathPlanner planner;
+  GridCell stack[GRID_MAP_CELLS]; // Explored cells that may still have unvisited neighbours
+  uint16_t depth;
+  GridCell position;
+  int heading;
+  GridPath route;                 // Shortest path back to the cell being backtracked to
+  uint16_t route_index;
+} Explorer;
+
+// Function to start exploring from a cell, facing a direction
+void explorer_init(Explorer* explorer, GridMap* map, GridCell start, int heading);
+
+// Function to convert walls seen relative to the robot into a wall mask for the map
+uint8_t explorer_walls_from_sensors(int heading, bool front, bool right, bool left);
+
+// Function to record the walls of the current cell and choose the next move.
+// Returns the direction to drive one cell in, or EXPLORER_DONE when every reachable
+// cell has been visited. The explorer assumes the move is made before the next call.
+int explorer_step(Explorer* explorer, uint8_t walls);
+
+#endif // EXPLORER_H
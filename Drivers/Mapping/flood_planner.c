@@ -0,0 +1,162 @@
+#include <string.h>
+#include "flood_planner.h"
+
+static inline bool test_bit(const uint32_t* bits, GridCell cell) {
+  return (bits[cell >> 5] >> (cell & 31)) & 1u;
+}
+
+static inline void set_bit(uint32_t* bits, GridCell cell) {
+  bits[cell >> 5] |= 1u << (cell & 31);
+}
+
+static inline void clear_bit(uint32_t* bits, GridCell cell) {
+  bits[cell >> 5] &= ~(1u << (cell & 31));
+}
+
+// The queue never holds a cell twice, so it never needs more than one slot per cell
+static void push(FloodPlanner* planner, GridCell cell) {
+  if (test_bit(planner->queued, cell)) {
+    return;
+  }
+  set_bit(planner->queued, cell);
+  planner->queue[(planner->head + planner->count) % GRID_MAP_CELLS] = cell;
+  planner->count++;
+}
+
+static GridCell pop(FloodPlanner* planner) {
+  GridCell cell = planner->queue[planner->head];
+  planner->head = (planner->head + 1) % GRID_MAP_CELLS;
+  planner->count--;
+  clear_bit(planner->queued, cell);
+  return cell;
+}
+
+// Function to get the shortest distance offered by the open neighbours of a cell, plus one
+static uint16_t best_through_neighbours(const FloodPlanner* planner, GridCell cell) {
+  uint16_t best = FLOOD_UNREACHABLE;
+  uint8_t open = grid_map_open_mask(planner->map, cell);
+
+  for (int dir = GRID_NORTH; dir <= GRID_WEST; dir++) {
+    GridCell next = grid_neighbour(cell, dir);
+    if ((open & GRID_WALL(dir)) && next != GRID_CELL_NONE &&
+        planner->distance[next] != FLOOD_UNREACHABLE && planner->distance[next] + 1 < best) {
+      best = planner->distance[next] + 1;
+    }
+  }
+  return best;
+}
+
+// Function to lower distances outwards from the queued cells until nothing improves
+static void relax(FloodPlanner* planner) {
+  while (planner->count > 0) {
+    GridCell cell = pop(planner);
+    uint16_t through = planner->distance[cell];
+    if (through == FLOOD_UNREACHABLE) {
+      continue;
+    }
+
+    uint8_t open = grid_map_open_mask(planner->map, cell);
+    for (int dir = GRID_NORTH; dir <= GRID_WEST; dir++) {
+      GridCell next = grid_neighbour(cell, dir);
+      if (!(open & GRID_WALL(dir)) || next == GRID_CELL_NONE) {
+        continue;
+      }
+      if (through + 1 < planner->distance[next]) {
+        planner->distance[next] = through + 1;
+        push(planner, next);
+      }
+    }
+  }
+}
+
+// Function to set the goal cells and flood the whole map once
+void flood_planner_init(FloodPlanner* planner, const GridMap* map, const GridCell* goals, int goal_count) {
+  planner->map = map;
+  memset(planner->distance, 0xFF, sizeof(planner->distance));
+  memset(planner->goal, 0, sizeof(planner->goal));
+  memset(planner->queued, 0, sizeof(planner->queued));
+  planner->head = 0;
+  planner->count = 0;
+
+  for (int i = 0; i < goal_count; i++) {
+    set_bit(planner->goal, goals[i]);
+    planner->distance[goals[i]] = 0;
+    push(planner, goals[i]);
+  }
+  relax(planner);
+}
+
+// Function to repair the field after walls of a cell changed.
+// A new wall can only cut paths through this cell and its neighbours, so the repair
+// first invalidates every cell that no longer has a neighbour one step closer to the
+// goal, then re-floods just those cells from the intact field around them.
+// A removed wall only shortens paths, which the final relaxation handles.
+void flood_planner_cell_changed(FloodPlanner* planner, GridCell cell) {
+  uint16_t invalidated = 0;
+
+  push(planner, cell);
+  for (int dir = GRID_NORTH; dir <= GRID_WEST; dir++) {
+    GridCell next = grid_neighbour(cell, dir);
+    if (next != GRID_CELL_NONE) {
+      push(planner, next);
+    }
+  }
+
+  // Invalidate cells that lost their support, spreading to the cells that relied on them
+  while (planner->count > 0) {
+    GridCell current = pop(planner);
+    uint16_t distance = planner->distance[current];
+    if (test_bit(planner->goal, current) || distance == FLOOD_UNREACHABLE ||
+        best_through_neighbours(planner, current) <= distance) {
+      continue;
+    }
+
+    planner->distance[current] = FLOOD_UNREACHABLE;
+    planner->invalidated[invalidated++] = current;
+
+    uint8_t open = grid_map_open_mask(planner->map, current);
+    for (int dir = GRID_NORTH; dir <= GRID_WEST; dir++) {
+      GridCell next = grid_neighbour(current, dir);
+      if ((open & GRID_WALL(dir)) && next != GRID_CELL_NONE && planner->distance[next] == distance + 1) {
+        push(planner, next);
+      }
+    }
+  }
+
+  // Give each invalidated cell the best distance its intact neighbours offer, then spread it
+  for (uint16_t i = 0; i < invalidated; i++) {
+    GridCell current = planner->invalidated[i];
+    planner->distance[current] = best_through_neighbours(planner, current);
+    push(planner, current);
+  }
+  push(planner, cell);
+  for (int dir = GRID_NORTH; dir <= GRID_WEST; dir++) {
+    GridCell next = grid_neighbour(cell, dir);
+    if (next != GRID_CELL_NONE) {
+      push(planner, next);
+    }
+  }
+  relax(planner);
+}
+
+// Function to get the direction that leads downhill towards the goal, preferring straight on
+int flood_planner_next_move(const FloodPlanner* planner, GridCell cell, int heading) {
+  static const int order[] = {0, 1, 3, 2};
+  uint16_t best = planner->distance[cell];
+  int best_dir = FLOOD_AT_GOAL;
+
+  if (best == 0 || best == FLOOD_UNREACHABLE) {
+    return FLOOD_AT_GOAL;
+  }
+
+  uint8_t open = grid_map_open_mask(planner->map, cell);
+  for (int i = 0; i < 4; i++) {
+    int dir = (heading + order[i]) & 3;
+    GridCell next = grid_neighbour(cell, dir);
+    if ((open & GRID_WALL(dir)) && next != GRID_CELL_NONE && planner->distance[next] < best) {
+      best = planner->distance[next];
+      best_dir = dir;
+    }
+  }
+  return best_dir;
+}
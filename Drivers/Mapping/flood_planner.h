@@ -0,0 +1,34 @@
+// flood_planner.h
+
+#ifndef FLOOD_PLANNER_H
+#define FLOOD_PLANNER_H
+
+#include "grid_map.h"
+
+#define FLOOD_UNREACHABLE 0xFFFF
+#define FLOOD_AT_GOAL     -1
+
+// Distance-to-goal field over the grid map, kept up to date incrementally as walls
+// are discovered. Only cells whose distance actually changes are touched.
+typedef struct {
+  const GridMap* map;
+  uint16_t distance[GRID_MAP_CELLS];             // Cells to the nearest goal, FLOOD_UNREACHABLE if cut off
+  uint32_t goal[(GRID_MAP_CELLS + 31) / 32];     // Goal cells, one bit each
+  GridCell queue[GRID_MAP_CELLS];                // Ring buffer of cells to recheck
+  uint16_t head;
+  uint16_t count;
+  uint32_t queued[(GRID_MAP_CELLS + 31) / 32];   // Cells currently in the queue
+  GridCell invalidated[GRID_MAP_CELLS];          // Cells that lost their path during a repair
+} FloodPlanner;
+
+// Function to set the goal cells and flood the whole map once
+void flood_planner_init(FloodPlanner* planner, const GridMap* map, const GridCell* goals, int goal_count);
+
+// Function to repair the field after walls of a cell changed (grid_map_set_wall or grid_map_observe)
+void flood_planner_cell_changed(FloodPlanner* planner, GridCell cell);
+
+// Function to get the direction that leads downhill towards the goal, preferring straight on.
+// Returns FLOOD_AT_GOAL at a goal cell or when the goal cannot be reached.
+int flood_planner_next_move(const FloodPlanner* planner, GridCell cell, int heading);
+
+#endif // FLOOD_PLANNER_H
@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <string.h>
+#include "grid_map.h"
+
+// Function to clear the map, leaving only the outer boundary walls
+void grid_map_init(GridMap* map) {
+  memset(map->cells, 0, sizeof(map->cells));
+
+  for (int x = 0; x < GRID_MAP_WIDTH; x++) {
+    map->cells[grid_cell(x, 0)] |= GRID_WALL(GRID_SOUTH);
+    map->cells[grid_cell(x, GRID_MAP_HEIGHT - 1)] |= GRID_WALL(GRID_NORTH);
+  }
+  for (int y = 0; y < GRID_MAP_HEIGHT; y++) {
+    map->cells[grid_cell(0, y)] |= GRID_WALL(GRID_WEST);
+    map->cells[grid_cell(GRID_MAP_WIDTH - 1, y)] |= GRID_WALL(GRID_EAST);
+  }
+}
+
+// Function to add or remove a wall, keeping both sides of it consistent
+void grid_map_set_wall(GridMap* map, GridCell cell, int dir, bool present) {
+  GridCell other = grid_neighbour(cell, dir);
+
+  // Boundary walls always stay
+  if (other == GRID_CELL_NONE) {
+    return;
+  }
+
+  if (present) {
+    map->cells[cell] |= GRID_WALL(dir);
+    map->cells[other] |= GRID_WALL(GRID_OPPOSITE(dir));
+  } else {
+    map->cells[cell] &= ~GRID_WALL(dir);
+    map->cells[other] &= ~GRID_WALL(GRID_OPPOSITE(dir));
+  }
+}
+
+// Function to record the four walls seen from a cell and mark it explored
+void grid_map_observe(GridMap* map, GridCell cell, uint8_t walls) {
+  for (int dir = GRID_NORTH; dir <= GRID_WEST; dir++) {
+    grid_map_set_wall(map, cell, dir, (walls & GRID_WALL(dir)) != 0);
+  }
+  map->cells[cell] |= GRID_EXPLORED | GRID_VISITED;
+}
+
+// Function to print the maze as ASCII art, north at the top
+void grid_map_print(const GridMap* map) {
+  for (int y = GRID_MAP_HEIGHT - 1; y >= 0; y--) {
+    for (int x = 0; x < GRID_MAP_WIDTH; x++) {
+      printf("+%s", grid_map_has_wall(map, grid_cell(x, y), GRID_NORTH) ? "---" : "   ");
+    }
+    printf("+\n");
+    for (int x = 0; x < GRID_MAP_WIDTH; x++) {
+      GridCell cell = grid_cell(x, y);
+      printf("%c %c ", grid_map_has_wall(map, cell, GRID_WEST) ? '|' : ' ',
+             grid_map_is_visited(map, cell) ? '.' : ' ');
+    }
+    printf("|\n");
+  }
+  for (int x = 0; x < GRID_MAP_WIDTH; x++) {
+    printf("+---");
+  }
+  printf("+\n");
+}
@@ -0,0 +1,102 @@
+// grid_map.h
+
+#ifndef GRID_MAP_H
+#define GRID_MAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Maze size in cells, can be overridden by the build
+#ifndef GRID_MAP_WIDTH
+#define GRID_MAP_WIDTH 8
+#endif
+#ifndef GRID_MAP_HEIGHT
+#define GRID_MAP_HEIGHT 8
+#endif
+#define GRID_MAP_CELLS (GRID_MAP_WIDTH * GRID_MAP_HEIGHT)
+
+// Directions, numbered clockwise so turning is an add mod 4
+#define GRID_NORTH 0
+#define GRID_EAST  1
+#define GRID_SOUTH 2
+#define GRID_WEST  3
+#define GRID_OPPOSITE(dir) (((dir) + 2) & 3)
+
+// Cell bits: one wall bit per direction in the low nibble, flags above
+#define GRID_WALL(dir)    (1u << (dir))
+#define GRID_WALL_MASK    0x0F
+#define GRID_VISITED      0x10 // Robot has been in the cell
+#define GRID_EXPLORED     0x20 // All four walls of the cell have been observed
+
+#define GRID_CELL_NONE 0xFFFF
+
+// Cell index, y * GRID_MAP_WIDTH + x
+typedef uint16_t GridCell;
+
+// Whole maze, one byte per cell, no heap
+typedef struct {
+  uint8_t cells[GRID_MAP_CELLS];
+} GridMap;
+
+// Function to clear the map, leaving only the outer boundary walls
+void grid_map_init(GridMap* map);
+
+// Function to add or remove a wall, keeping both sides of it consistent
+void grid_map_set_wall(GridMap* map, GridCell cell, int dir, bool present);
+
+// Function to record the four walls seen from a cell and mark it explored
+void grid_map_observe(GridMap* map, GridCell cell, uint8_t walls);
+
+// Function to print the maze as ASCII art
+void grid_map_print(const GridMap* map);
+
+// Function to get the index of the cell at x, y
+static inline GridCell grid_cell(int x, int y) {
+  return (GridCell)(y * GRID_MAP_WIDTH + x);
+}
+
+static inline int grid_cell_x(GridCell cell) {
+  return cell % GRID_MAP_WIDTH;
+}
+
+static inline int grid_cell_y(GridCell cell) {
+  return cell / GRID_MAP_WIDTH;
+}
+
+// Function to get the neighbouring cell in a direction, GRID_CELL_NONE off the grid
+static inline GridCell grid_neighbour(GridCell cell, int dir) {
+  switch (dir) {
+    case GRID_NORTH: return (cell >= GRID_MAP_WIDTH * (GRID_MAP_HEIGHT - 1)) ? GRID_CELL_NONE : cell + GRID_MAP_WIDTH;
+    case GRID_EAST:  return (grid_cell_x(cell) == GRID_MAP_WIDTH - 1) ? GRID_CELL_NONE : cell + 1;
+    case GRID_SOUTH: return (cell < GRID_MAP_WIDTH) ? GRID_CELL_NONE : cell - GRID_MAP_WIDTH;
+    default:         return (grid_cell_x(cell) == 0) ? GRID_CELL_NONE : cell - 1;
+  }
+}
+
+static inline bool grid_map_has_wall(const GridMap* map, GridCell cell, int dir) {
+  return (map->cells[cell] & GRID_WALL(dir)) != 0;
+}
+
+// Function to get the directions that are open from a cell as a 4-bit mask
+static inline uint8_t grid_map_open_mask(const GridMap* map, GridCell cell) {
+  return ~map->cells[cell] & GRID_WALL_MASK;
+}
+
+// Function to get the neighbour through an open side, GRID_CELL_NONE if walled
+static inline GridCell grid_map_open_neighbour(const GridMap* map, GridCell cell, int dir) {
+  return grid_map_has_wall(map, cell, dir) ? GRID_CELL_NONE : grid_neighbour(cell, dir);
+}
+
+static inline bool grid_map_is_visited(const GridMap* map, GridCell cell) {
+  return (map->cells[cell] & GRID_VISITED) != 0;
+}
+
+static inline void grid_map_mark_visited(GridMap* map, GridCell cell) {
+  map->cells[cell] |= GRID_VISITED;
+}
+
+static inline bool grid_map_is_explored(const GridMap* map, GridCell cell) {
+  return (map->cells[cell] & GRID_EXPLORED) != 0;
+}
+
+#endif // GRID_MAP_H
@@ -0,0 +1,73 @@
+#include <string.h>
+#include "map_cache.h"
+#include "flash_store.h"
+
+// Stored layout. The size fields reject a map from a build with a different grid;
+// the flash record header adds the CRC.
+typedef struct {
+  uint16_t version;
+  uint8_t width;
+  uint8_t height;
+  uint16_t start;
+  uint8_t heading;
+  uint8_t fingerprint_count;
+  char fingerprint[MAP_CACHE_FINGERPRINT_LENGTH];
+  uint8_t cells[GRID_MAP_CELLS];
+} MapRecord;
+
+_Static_assert(sizeof(MapRecord) <= FLASH_STORE_MAX_LENGTH, "map record does not fit its flash sector");
+
+// Function to clear a fingerprint
+void map_cache_fingerprint_init(MapFingerprint* fingerprint) {
+  memset(fingerprint, 0, sizeof(*fingerprint));
+}
+
+// Function to append a decoded barcode character
+void map_cache_fingerprint_add(MapFingerprint* fingerprint, char character) {
+  if (fingerprint->count < MAP_CACHE_FINGERPRINT_LENGTH) {
+    fingerprint->characters[fingerprint->count++] = character;
+  }
+}
+
+// Function to store a fully explored map with the start pose it was explored from
+bool map_cache_save(const GridMap* map, const MapFingerprint* fingerprint, GridCell start, int heading) {
+  static MapRecord record;
+
+  memset(&record, 0, sizeof(record));
+  record.version = MAP_CACHE_VERSION;
+  record.width = GRID_MAP_WIDTH;
+  record.height = GRID_MAP_HEIGHT;
+  record.start = start;
+  record.heading = (uint8_t)(heading & 3);
+  record.fingerprint_count = fingerprint->count;
+  memcpy(record.fingerprint, fingerprint->characters, fingerprint->count);
+  for (int i = 0; i < GRID_MAP_CELLS; i++) {
+    record.cells[i] = map->cells[i] & (GRID_WALL_MASK | GRID_EXPLORED);
+  }
+
+  return flash_store_save(FLASH_STORE_MAP_OFFSET, FLASH_RECORD_MAP, &record, sizeof(record));
+}
+
+// Function to load the stored map if it was saved for this course by this build
+bool map_cache_load(GridMap* map, const MapFingerprint* fingerprint, GridCell* start, int* heading) {
+  static MapRecord record;
+
+  if (!flash_store_load(FLASH_STORE_MAP_OFFSET, FLASH_RECORD_MAP, &record, sizeof(record))) {
+    return false;
+  }
+  if (record.version != MAP_CACHE_VERSION || record.width != GRID_MAP_WIDTH ||
+      record.height != GRID_MAP_HEIGHT || record.start >= GRID_MAP_CELLS) {
+    return false;
+  }
+
+  // Only reuse the map on the course it was made on
+  if (record.fingerprint_count != fingerprint->count ||
+      memcmp(record.fingerprint, fingerprint->characters, fingerprint->count) != 0) {
+    return false;
+  }
+
+  memcpy(map->cells, record.cells, sizeof(map->cells));
+  *start = record.start;
+  *heading = record.heading;
+  return true;
+}
@@ -0,0 +1,30 @@
+// map_cache.h
+
+#ifndef MAP_CACHE_H
+#define MAP_CACHE_H
+
+#include "grid_map.h"
+
+#define MAP_CACHE_VERSION            1
+#define MAP_CACHE_FINGERPRINT_LENGTH 8  // Barcode characters that identify a course
+
+// Identity of a course: the barcode characters read at the start, in order
+typedef struct {
+  char characters[MAP_CACHE_FINGERPRINT_LENGTH];
+  uint8_t count;
+} MapFingerprint;
+
+// Function to clear a fingerprint
+void map_cache_fingerprint_init(MapFingerprint* fingerprint);
+
+// Function to append a decoded barcode character, extra characters past the length are ignored
+void map_cache_fingerprint_add(MapFingerprint* fingerprint, char character);
+
+// Function to store a fully explored map with the start pose it was explored from
+bool map_cache_save(const GridMap* map, const MapFingerprint* fingerprint, GridCell start, int heading);
+
+// Function to load the stored map if it was saved for this course by this build.
+// Visited flags are cleared, the new run has not been anywhere yet.
+bool map_cache_load(GridMap* map, const MapFingerprint* fingerprint, GridCell* start, int* heading);
+
+#endif // MAP_CACHE_H
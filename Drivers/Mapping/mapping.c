@@ -1,43 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
-#define SIZE 40
-
-// Define a queue structure for BFS
-struct queue {
-  int items[SIZE];
-  int front;
-  int rear;
-};
-
-// Function declarations related to the queue
-struct queue* createQueue();
-void enqueue(struct queue* q, int);
-int dequeue(struct queue* q);
-void display(struct queue* q);
-int isEmpty(struct queue* q);
-void printQueue(struct queue* q);
-
-// Define a node structure for the adjacency list
-struct node {
-  int vertex;
-  struct node* next;
-};
-
-// Function to create a new node
-struct node* createNode(int v);
-
-// Define a Graph structure
-struct Graph {
-  int numVertices;
-  int* visited;
-  struct node** adjLists; // Pointer to an array of adjacency lists
-};
-
-// BFS algorithm declaration
-void bfs(struct Graph* graph, int startVertex);
-
-// DFS algorithm declaration
-void DFS(struct Graph* graph, int vertex);
+#include "mapping.h"
 
 // Function to create a new node
 struct node* createNode(int v) {
@@ -90,7 +53,7 @@ int isEmpty(struct queue* q) {
 
 // Function to add an element to the queue
 void enqueue(struct queue* q, int value) {
-  if (q->rear == SIZE - 1)
+  if (q->rear == MAPPING_QUEUE_SIZE - 1)
     printf("\nQueue is Full!!");
   else {
     if (q->front == -1)
@@ -135,7 +98,6 @@ void bfs(struct Graph* graph, int startVertex) {
   enqueue(q, startVertex);
 
   while (!isEmpty(q)) {
-    printQueue(q);
     int currentVertex = dequeue(q);
     printf("Visited %d\n", currentVertex);
 
@@ -149,6 +111,8 @@ void bfs(struct Graph* graph, int startVertex) {
       temp = temp->next;
     }
   }
+
+  free(q);
 }
 
 // DFS algorithm implementation
@@ -179,6 +143,8 @@ void printGraph(struct Graph* graph) {
   }
 }
 
+// Build with MAPPING_NO_MAIN when linking these functions into another program
+#ifndef MAPPING_NO_MAIN
 int main() {
   struct Graph* graph = createGraph(4);
   addEdge(graph, 0, 1);
@@ -192,3 +158,4 @@ int main() {
 
   return 0;
 }
+#endif
@@ -0,0 +1,54 @@
+// mapping.h
+
+#ifndef MAPPING_H
+#define MAPPING_H
+
+#define MAPPING_QUEUE_SIZE 40
+
+// Define a queue structure for BFS
+struct queue {
+  int items[MAPPING_QUEUE_SIZE];
+  int front;
+  int rear;
+};
+
+// Function declarations related to the queue
+struct queue* createQueue();
+void enqueue(struct queue* q, int);
+int dequeue(struct queue* q);
+void display(struct queue* q);
+int isEmpty(struct queue* q);
+void printQueue(struct queue* q);
+
+// Define a node structure for the adjacency list
+struct node {
+  int vertex;
+  struct node* next;
+};
+
+// Function to create a new node
+struct node* createNode(int v);
+
+// Define a Graph structure
+struct Graph {
+  int numVertices;
+  int* visited;
+  struct node** adjLists; // Pointer to an array of adjacency lists
+};
+
+// Function to create a graph with a given number of vertices
+struct Graph* createGraph(int vertices);
+
+// Function to add an edge to the graph
+void addEdge(struct Graph* graph, int src, int dest);
+
+// BFS algorithm declaration
+void bfs(struct Graph* graph, int startVertex);
+
+// DFS algorithm declaration
+void DFS(struct Graph* graph, int vertex);
+
+// Function to print the adjacency list representation of the graph
+void printGraph(struct Graph* graph);
+
+#endif // MAPPING_H
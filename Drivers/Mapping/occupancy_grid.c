@@ -0,0 +1,129 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "occupancy_grid.h"
+
+// Function to mark every cell unknown
+void occupancy_grid_init(OccupancyGrid* grid) {
+  memset(grid->cells, 0, sizeof(grid->cells));
+}
+
+// Function to get the cell containing a point of the odometry frame
+bool occupancy_grid_world_to_cell(float x_cm, float y_cm, int* cx, int* cy) {
+  *cx = (int)floorf(x_cm / OCC_GRID_RESOLUTION_CM) + OCC_GRID_SIZE / 2;
+  *cy = (int)floorf(y_cm / OCC_GRID_RESOLUTION_CM) + OCC_GRID_SIZE / 2;
+  return *cx >= 0 && *cx < OCC_GRID_SIZE && *cy >= 0 && *cy < OCC_GRID_SIZE;
+}
+
+// Function to add a log-odds step to a cell, saturating at the limit
+static void add_log_odds(OccupancyGrid* grid, int cx, int cy, int step) {
+  int8_t* cell = &grid->cells[cy * OCC_GRID_SIZE + cx];
+  int value = *cell + step;
+  if (value > OCC_LOG_ODDS_LIMIT) value = OCC_LOG_ODDS_LIMIT;
+  if (value < -OCC_LOG_ODDS_LIMIT) value = -OCC_LOG_ODDS_LIMIT;
+  *cell = (int8_t)value;
+}
+
+// Function to ray-cast one range reading from the robot pose
+void occupancy_grid_update(OccupancyGrid* grid, const Pose* pose, float range_cm) {
+  float dir_x = cosf(pose->heading_rad);
+  float dir_y = sinf(pose->heading_rad);
+  float sensor_x = pose->x_cm + OCC_SENSOR_OFFSET_CM * dir_x;
+  float sensor_y = pose->y_cm + OCC_SENSOR_OFFSET_CM * dir_y;
+
+  // No echo or a far one: clear the beam up to the trusted range, mark nothing occupied
+  bool hit = range_cm > 0.0f && range_cm < OCC_MAX_RANGE_CM;
+  if (!hit) {
+    range_cm = OCC_MAX_RANGE_CM;
+  }
+
+  int x0, y0, x1, y1;
+  occupancy_grid_world_to_cell(sensor_x, sensor_y, &x0, &y0);
+  occupancy_grid_world_to_cell(sensor_x + range_cm * dir_x, sensor_y + range_cm * dir_y, &x1, &y1);
+
+  // Bresenham line from the sensor cell to the echo cell, integer steps only
+  int dx = abs(x1 - x0);
+  int dy = -abs(y1 - y0);
+  int sx = (x0 < x1) ? 1 : -1;
+  int sy = (y0 < y1) ? 1 : -1;
+  int err = dx + dy;
+
+  while (1) {
+    bool inside = x0 >= 0 && x0 < OCC_GRID_SIZE && y0 >= 0 && y0 < OCC_GRID_SIZE;
+    if (x0 == x1 && y0 == y1) {
+      if (inside) {
+        add_log_odds(grid, x0, y0, hit ? OCC_LOG_ODDS_HIT : OCC_LOG_ODDS_MISS);
+      }
+      break;
+    }
+    if (inside) {
+      add_log_odds(grid, x0, y0, OCC_LOG_ODDS_MISS);
+    }
+
+    int e2 = 2 * err;
+    if (e2 >= dy) {
+      err += dy;
+      x0 += sx;
+    }
+    if (e2 <= dx) {
+      err += dx;
+      y0 += sy;
+    }
+  }
+}
+
+// Function to check whether a free cell borders an unknown one
+static bool is_frontier(const OccupancyGrid* grid, int cx, int cy) {
+  static const int offsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+  if (!occupancy_grid_is_free(grid, cx, cy)) {
+    return false;
+  }
+  for (int i = 0; i < 4; i++) {
+    int nx = cx + offsets[i][0];
+    int ny = cy + offsets[i][1];
+    if (nx < 0 || nx >= OCC_GRID_SIZE || ny < 0 || ny >= OCC_GRID_SIZE) {
+      continue;
+    }
+    int8_t value = occupancy_grid_at(grid, nx, ny);
+    if (value >= OCC_FREE_LEVEL && value <= OCC_OCCUPIED_LEVEL) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Function to list frontier cells
+int occupancy_grid_frontiers(const OccupancyGrid* grid, uint16_t* frontiers, int max_frontiers) {
+  int count = 0;
+  for (int cy = 0; cy < OCC_GRID_SIZE && count < max_frontiers; cy++) {
+    for (int cx = 0; cx < OCC_GRID_SIZE && count < max_frontiers; cx++) {
+      if (is_frontier(grid, cx, cy)) {
+        frontiers[count++] = (uint16_t)(cy * OCC_GRID_SIZE + cx);
+      }
+    }
+  }
+  return count;
+}
+
+// Function to find the frontier cell nearest to a point
+bool occupancy_grid_nearest_frontier(const OccupancyGrid* grid, float x_cm, float y_cm, int* cx, int* cy) {
+  int px, py;
+  occupancy_grid_world_to_cell(x_cm, y_cm, &px, &py);
+
+  int best = -1;
+  for (int y = 0; y < OCC_GRID_SIZE; y++) {
+    for (int x = 0; x < OCC_GRID_SIZE; x++) {
+      if (!is_frontier(grid, x, y)) {
+        continue;
+      }
+      int distance = (x - px) * (x - px) + (y - py) * (y - py);
+      if (best < 0 || distance < best) {
+        best = distance;
+        *cx = x;
+        *cy = y;
+      }
+    }
+  }
+  return best >= 0;
+}
@@ -0,0 +1,57 @@
+// occupancy_grid.h
+
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "odometry.h"
+
+// 64 x 64 cells of 5 cm cover 3.2 m square in 4 KB, the robot starts at the centre
+#define OCC_GRID_SIZE          64
+#define OCC_GRID_RESOLUTION_CM 5.0f
+
+// Log-odds steps in units of about 0.05, saturating well inside int8 so a cell can change its mind
+#define OCC_LOG_ODDS_HIT   12
+#define OCC_LOG_ODDS_MISS  -4
+#define OCC_LOG_ODDS_LIMIT 100
+#define OCC_OCCUPIED_LEVEL 40   // Above this a cell counts as occupied
+#define OCC_FREE_LEVEL     -20  // Below this a cell counts as free, in between is unknown
+
+#define OCC_SENSOR_OFFSET_CM 8.0f    // HC-SR04 distance ahead of the wheel axle
+#define OCC_MAX_RANGE_CM     200.0f  // Readings beyond this only clear space, the echo is unreliable
+
+typedef struct {
+  int8_t cells[OCC_GRID_SIZE * OCC_GRID_SIZE];  // Log-odds of occupancy, 0 = unknown
+} OccupancyGrid;
+
+// Function to mark every cell unknown
+void occupancy_grid_init(OccupancyGrid* grid);
+
+// Function to get the cell containing a point of the odometry frame, false if outside the grid
+bool occupancy_grid_world_to_cell(float x_cm, float y_cm, int* cx, int* cy);
+
+// Function to ray-cast one range reading from the robot pose: cells along the beam become
+// more likely free and the cell at the echo more likely occupied
+void occupancy_grid_update(OccupancyGrid* grid, const Pose* pose, float range_cm);
+
+// Function to list frontier cells (free cells next to unknown ones) as y * OCC_GRID_SIZE + x.
+// Returns the number found, at most max_frontiers.
+int occupancy_grid_frontiers(const OccupancyGrid* grid, uint16_t* frontiers, int max_frontiers);
+
+// Function to find the frontier cell nearest to a point, false if there are none
+bool occupancy_grid_nearest_frontier(const OccupancyGrid* grid, float x_cm, float y_cm, int* cx, int* cy);
+
+static inline int8_t occupancy_grid_at(const OccupancyGrid* grid, int cx, int cy) {
+  return grid->cells[cy * OCC_GRID_SIZE + cx];
+}
+
+static inline bool occupancy_grid_is_occupied(const OccupancyGrid* grid, int cx, int cy) {
+  return occupancy_grid_at(grid, cx, cy) > OCC_OCCUPIED_LEVEL;
+}
+
+static inline bool occupancy_grid_is_free(const OccupancyGrid* grid, int cx, int cy) {
+  return occupancy_grid_at(grid, cx, cy) < OCC_FREE_LEVEL;
+}
+
+#endif // OCCUPANCY_GRID_H
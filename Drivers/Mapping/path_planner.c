@@ -0,0 +1,71 @@
+#include <string.h>
+#include "path_planner.h"
+
+static inline bool is_visited(const PathPlanner* planner, GridCell cell) {
+  return (planner->visited[cell >> 5] >> (cell & 31)) & 1u;
+}
+
+static inline void set_visited(PathPlanner* planner, GridCell cell) {
+  planner->visited[cell >> 5] |= 1u << (cell & 31);
+}
+
+// Function to run a breadth-first search from start until goal is dequeued.
+// Every edge costs one cell, so breadth-first order already gives the shortest path
+// and a heap for A* would only add work.
+static bool search(PathPlanner* planner, const GridMap* map, GridCell start, GridCell goal) {
+  // Each cell is enqueued at most once, so the ring never overflows
+  uint16_t head = 0;
+  uint16_t count = 0;
+
+  memset(planner->visited, 0, sizeof(planner->visited));
+  set_visited(planner, start);
+  planner->parent[start] = GRID_CELL_NONE;
+  planner->queue[0] = start;
+  count = 1;
+
+  while (count > 0) {
+    GridCell cell = planner->queue[head];
+    head = (head + 1) % GRID_MAP_CELLS;
+    count--;
+
+    if (cell == goal) {
+      return true;
+    }
+
+    uint8_t open = grid_map_open_mask(map, cell);
+    for (int dir = GRID_NORTH; dir <= GRID_WEST; dir++) {
+      if (!(open & GRID_WALL(dir))) {
+        continue;
+      }
+      GridCell next = grid_neighbour(cell, dir);
+      if (next == GRID_CELL_NONE || is_visited(planner, next)) {
+        continue;
+      }
+      set_visited(planner, next);
+      planner->parent[next] = cell;
+      planner->queue[(head + count) % GRID_MAP_CELLS] = next;
+      count++;
+    }
+  }
+
+  return false;
+}
+
+// Function to find the shortest path between two cells
+bool path_planner_shortest(PathPlanner* planner, const GridMap* map, GridCell start, GridCell goal, GridPath* path) {
+  path->length = 0;
+  if (!search(planner, map, start, goal)) {
+    return false;
+  }
+
+  // Count the steps back to the start, then fill the path from the end
+  uint16_t length = 0;
+  for (GridCell cell = goal; cell != GRID_CELL_NONE; cell = planner->parent[cell]) {
+    length++;
+  }
+  path->length = length;
+  for (GridCell cell = goal; cell != GRID_CELL_NONE; cell = planner->parent[cell]) {
+    path->cells[--length] = cell;
+  }
+  return true;
+}
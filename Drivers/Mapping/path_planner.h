@@ -0,0 +1,25 @@
+// path_planner.h
+
+#ifndef PATH_PLANNER_H
+#define PATH_PLANNER_H
+
+#include "grid_map.h"
+
+// Sequence of cells from start to goal, both included
+typedef struct {
+  GridCell cells[GRID_MAP_CELLS];
+  uint16_t length;
+} GridPath;
+
+// Working storage for one search, sized for the whole maze so nothing is allocated
+typedef struct {
+  GridCell queue[GRID_MAP_CELLS];           // Ring buffer of cells to expand
+  uint32_t visited[(GRID_MAP_CELLS + 31) / 32]; // One bit per cell
+  GridCell parent[GRID_MAP_CELLS];          // Cell each one was reached from
+} PathPlanner;
+
+// Function to find the shortest path between two cells, false if the goal cannot be reached.
+// Walls that have not been observed yet are treated as open.
+bool path_planner_shortest(PathPlanner* planner, const GridMap* map, GridCell start, GridCell goal, GridPath* path);
+
+#endif // PATH_PLANNER_H
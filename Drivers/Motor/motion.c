@@ -0,0 +1,124 @@
+#include "motion.h"
+#include "odometry.h"
+#include "hardware/pwm.h"
+
+// Speed loop state for one wheel
+typedef struct {
+    float target_cm_s;
+    float integral;
+} WheelControl;
+
+static WheelControl left_control;
+static WheelControl right_control;
+static bool speed_control = false;  // Off while driving by duty cycle directly
+
+// Function to set the direction pins and duty cycle of one motor
+static void set_motor(uint en_pin, uint forward_pin, uint backward_pin, float duty) {
+    if (duty > 1.0f) duty = 1.0f;
+    if (duty < -1.0f) duty = -1.0f;
+
+    gpio_put(forward_pin, duty > 0.0f);
+    gpio_put(backward_pin, duty < 0.0f);
+    float level = (duty < 0.0f ? -duty : duty) * MOTION_PWM_WRAP;
+    pwm_set_chan_level(pwm_gpio_to_slice_num(en_pin), pwm_gpio_to_channel(en_pin), (uint16_t)level);
+}
+
+// Function to set up the direction pins and PWM for both motors
+void motion_init() {
+    uint pins[] = {IN1_PIN, IN2_PIN, IN3_PIN, IN4_PIN};
+    for (int i = 0; i < 4; i++) {
+        gpio_init(pins[i]);
+        gpio_set_dir(pins[i], GPIO_OUT);
+        gpio_put(pins[i], false);
+    }
+
+    uint en_pins[] = {EN_A_PIN, EN_B_PIN};
+    for (int i = 0; i < 2; i++) {
+        gpio_set_function(en_pins[i], GPIO_FUNC_PWM);
+        uint slice = pwm_gpio_to_slice_num(en_pins[i]);
+        pwm_set_clkdiv_int_frac(slice, 1, 15);
+        pwm_set_wrap(slice, MOTION_PWM_WRAP);
+        pwm_set_chan_level(slice, pwm_gpio_to_channel(en_pins[i]), 0);
+        pwm_set_enabled(slice, true);
+    }
+}
+
+// Function to apply both duty cycles
+static void apply_duty(float left, float right) {
+    set_motor(EN_A_PIN, IN1_PIN, IN2_PIN, left * MOTION_LEFT_ADJUSTMENT);
+    set_motor(EN_B_PIN, IN4_PIN, IN3_PIN, right);
+
+    // The encoders only count notches, tell odometry which way the wheels turn.
+    // A wheel with no drive keeps its last direction while it coasts.
+    static int left_direction = 1;
+    static int right_direction = 1;
+    if (left != 0.0f) left_direction = (left < 0.0f) ? -1 : 1;
+    if (right != 0.0f) right_direction = (right < 0.0f) ? -1 : 1;
+    odometry_set_direction(left_direction, right_direction);
+}
+
+// Function to drive each wheel at a signed duty cycle
+void motion_set_wheel_duty(float left, float right) {
+    speed_control = false;
+    apply_duty(left, right);
+}
+
+// Function to drive each wheel at a signed speed in cm/s
+void motion_set_wheel_speed(float left_cm_s, float right_cm_s) {
+    // Reversing or stopping a wheel discards what the integral learnt at the old speed
+    if (!speed_control || left_cm_s * left_control.target_cm_s <= 0.0f) {
+        left_control.integral = 0.0f;
+    }
+    if (!speed_control || right_cm_s * right_control.target_cm_s <= 0.0f) {
+        right_control.integral = 0.0f;
+    }
+    left_control.target_cm_s = left_cm_s;
+    right_control.target_cm_s = right_cm_s;
+    speed_control = true;
+
+    apply_duty(left_cm_s / MOTION_MAX_SPEED_CM_S + left_control.integral,
+               right_cm_s / MOTION_MAX_SPEED_CM_S + right_control.integral);
+}
+
+// Function to run the PI step for one wheel and return its duty cycle
+static float control_wheel(WheelControl *control, float measured_cm_s, float dt_s) {
+    if (control->target_cm_s == 0.0f) {
+        control->integral = 0.0f;
+        return 0.0f;
+    }
+
+    float error = control->target_cm_s - measured_cm_s;
+    control->integral += MOTION_SPEED_KI * error * dt_s;
+    if (control->integral > MOTION_INTEGRAL_LIMIT) control->integral = MOTION_INTEGRAL_LIMIT;
+    if (control->integral < -MOTION_INTEGRAL_LIMIT) control->integral = -MOTION_INTEGRAL_LIMIT;
+
+    // Never drive against the target direction: the encoders only know direction
+    // from the duty sign, so reversing to brake would make odometry count backwards
+    float duty = control->target_cm_s / MOTION_MAX_SPEED_CM_S + MOTION_SPEED_KP * error + control->integral;
+    if (control->target_cm_s > 0.0f && duty < 0.0f) duty = 0.0f;
+    if (control->target_cm_s < 0.0f && duty > 0.0f) duty = 0.0f;
+    return duty;
+}
+
+// Function to correct the wheel duty cycles towards the speed targets
+void motion_control_update(float dt_s) {
+    if (!speed_control) {
+        return;
+    }
+
+    float left_cm_s, right_cm_s;
+    odometry_wheel_speeds(&left_cm_s, &right_cm_s);
+    apply_duty(control_wheel(&left_control, left_cm_s, dt_s),
+               control_wheel(&right_control, right_cm_s, dt_s));
+}
+
+// Function to drive at a forward speed while turning, counter-clockwise positive
+void motion_set_velocity(float linear_cm_s, float angular_rad_s) {
+    float half_difference = 0.5f * angular_rad_s * ODOMETRY_TRACK_WIDTH_CM;
+    motion_set_wheel_speed(linear_cm_s - half_difference, linear_cm_s + half_difference);
+}
+
+// Function to stop both motors
+void motion_stop() {
+    motion_set_wheel_duty(0.0f, 0.0f);
+}
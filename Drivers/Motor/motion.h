@@ -0,0 +1,44 @@
+// motion.h
+
+#ifndef MOTION_H
+#define MOTION_H
+
+#include "pico/stdlib.h"
+
+// L298N pins, same wiring as the programs in Main
+#define IN1_PIN  6
+#define IN2_PIN  7
+#define IN3_PIN  4
+#define IN4_PIN  3
+#define EN_A_PIN 8  // Left motor
+#define EN_B_PIN 2  // Right motor
+
+#define MOTION_PWM_WRAP         64515
+#define MOTION_LEFT_ADJUSTMENT  0.965f  // Left motor is slightly stronger
+#define MOTION_MAX_SPEED_CM_S   60.0f   // Wheel speed reached at full duty cycle
+
+// Wheel-speed PI gains, on top of the open-loop feedforward
+#define MOTION_SPEED_KP         0.008f  // Duty per cm/s of error
+#define MOTION_SPEED_KI         0.04f   // Duty per cm of accumulated error
+#define MOTION_INTEGRAL_LIMIT   0.3f    // Largest duty correction the integral may build up
+
+// Function to set up the direction pins and PWM for both motors
+void motion_init();
+
+// Function to drive each wheel at a signed duty cycle, -1.0 (full reverse) to 1.0 (full forward)
+void motion_set_wheel_duty(float left, float right);
+
+// Function to drive each wheel at a signed speed in cm/s. Starts from the open-loop duty,
+// motion_control_update then closes the loop on the encoder speeds.
+void motion_set_wheel_speed(float left_cm_s, float right_cm_s);
+
+// Function to drive at a forward speed while turning, counter-clockwise positive
+void motion_set_velocity(float linear_cm_s, float angular_rad_s);
+
+// Function to correct the wheel duty cycles towards the speed targets, call at the control rate
+void motion_control_update(float dt_s);
+
+// Function to stop both motors
+void motion_stop();
+
+#endif // MOTION_H
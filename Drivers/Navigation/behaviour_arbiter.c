@@ -0,0 +1,79 @@
+#include "behaviour_arbiter.h"
+#include "motion.h"
+
+// Function to clear the behaviour list
+void arbiter_init(BehaviourArbiter *arbiter) {
+    arbiter->count = 0;
+    arbiter->winner = NULL;
+    arbiter->output.linear_cm_s = 0.0f;
+    arbiter->output.angular_rad_s = 0.0f;
+    arbiter->period_us = ARBITER_PERIOD_US;
+    arbiter->speed_control = true;
+}
+
+// Function to add a behaviour
+bool arbiter_add(BehaviourArbiter *arbiter, const char *name, uint8_t priority, BehaviourKind kind,
+                 BehaviourFunction function, void *context) {
+    if (arbiter->count >= ARBITER_MAX_BEHAVIOURS) {
+        return false;
+    }
+    Behaviour *behaviour = &arbiter->behaviours[arbiter->count++];
+    behaviour->name = name;
+    behaviour->priority = priority;
+    behaviour->kind = kind;
+    behaviour->function = function;
+    behaviour->context = context;
+    return true;
+}
+
+// Function to run every behaviour once, pick the command and send it to the motors
+void arbiter_step(BehaviourArbiter *arbiter, uint32_t now_us) {
+    const Behaviour *winner = NULL;
+    BehaviourRequest command = {0.0f, 0.0f};
+    float speed_limit = -1.0f;  // Negative while no limit is active
+
+    // Every behaviour runs every period so their filters stay up to date even when they lose
+    for (int i = 0; i < arbiter->count; i++) {
+        const Behaviour *behaviour = &arbiter->behaviours[i];
+        BehaviourRequest request;
+        if (!behaviour->function(behaviour->context, now_us, &request)) {
+            continue;
+        }
+
+        if (behaviour->kind == BEHAVIOUR_LIMIT) {
+            float limit = (request.linear_cm_s > 0.0f) ? request.linear_cm_s : 0.0f;
+            if (speed_limit < 0.0f || limit < speed_limit) {
+                speed_limit = limit;
+            }
+        } else if (winner == NULL || behaviour->priority > winner->priority) {
+            winner = behaviour;
+            command = request;
+        }
+    }
+
+    // Limits only slow forward driving. The turn rate is scaled with the speed so the robot
+    // keeps to the same curve, unless it was turning in place.
+    if (speed_limit >= 0.0f && command.linear_cm_s > speed_limit) {
+        if (command.linear_cm_s > 0.0f) {
+            command.angular_rad_s *= speed_limit / command.linear_cm_s;
+        }
+        command.linear_cm_s = speed_limit;
+    }
+
+    arbiter->winner = (winner != NULL) ? winner->name : NULL;
+    arbiter->output = command;
+    motion_set_velocity(command.linear_cm_s, command.angular_rad_s);
+    if (arbiter->speed_control) {
+        motion_control_update(arbiter->period_us / 1000000.0f);
+    }
+}
+
+// Function to call arbiter_step every period_us, never returns
+void arbiter_run(BehaviourArbiter *arbiter) {
+    absolute_time_t next_step = get_absolute_time();
+    while (1) {
+        next_step = delayed_by_us(next_step, arbiter->period_us);
+        arbiter_step(arbiter, time_us_32());
+        sleep_until(next_step);
+    }
+}
@@ -0,0 +1,65 @@
+// behaviour_arbiter.h
+
+#ifndef BEHAVIOUR_ARBITER_H
+#define BEHAVIOUR_ARBITER_H
+
+#include "pico/stdlib.h"
+
+#define ARBITER_MAX_BEHAVIOURS 8
+#define ARBITER_PERIOD_US      20000  // Default period: behaviours run and the motors are updated at 50 Hz
+
+// Priorities, a higher number wins
+#define BEHAVIOUR_PRIORITY_SAFETY      100  // Obstacle braking and escape
+#define BEHAVIOUR_PRIORITY_BARCODE      80  // Stopping at a barcode
+#define BEHAVIOUR_PRIORITY_LINE         60  // Line following
+#define BEHAVIOUR_PRIORITY_WALL         50  // Wall following
+#define BEHAVIOUR_PRIORITY_NAVIGATION   40  // Route driving and local planning
+
+typedef enum {
+    BEHAVIOUR_COMMAND,  // Wants to drive: the highest-priority command wins outright
+    BEHAVIOUR_LIMIT     // Only caps forward speed: every active limit is applied to the winner
+} BehaviourKind;
+
+// What a behaviour asks for in one period
+typedef struct {
+    float linear_cm_s;
+    float angular_rad_s;  // Counter-clockwise positive, ignored for limits
+} BehaviourRequest;
+
+// Called once per period; returns false when the behaviour has nothing to say this period
+typedef bool (*BehaviourFunction)(void *context, uint32_t now_us, BehaviourRequest *request);
+
+typedef struct {
+    const char *name;
+    uint8_t priority;
+    BehaviourKind kind;
+    BehaviourFunction function;
+    void *context;
+} Behaviour;
+
+typedef struct {
+    Behaviour behaviours[ARBITER_MAX_BEHAVIOURS];
+    int count;
+    const char *winner;        // Name of the behaviour driving in the last period, NULL when stopped
+    BehaviourRequest output;   // Command sent to the motors in the last period
+
+    // Set by arbiter_init, may be changed before the first step
+    uint32_t period_us;        // Time between steps, ARBITER_PERIOD_US by default
+    bool speed_control;        // Run the wheel speed loop; off when the encoders are not wired
+} BehaviourArbiter;
+
+// Function to clear the behaviour list
+void arbiter_init(BehaviourArbiter *arbiter);
+
+// Function to add a behaviour, returns false when the list is full
+bool arbiter_add(BehaviourArbiter *arbiter, const char *name, uint8_t priority, BehaviourKind kind,
+                 BehaviourFunction function, void *context);
+
+// Function to run every behaviour once, pick the command and send it to the motors.
+// This is the only place that drives the motors once the arbiter is in use.
+void arbiter_step(BehaviourArbiter *arbiter, uint32_t now_us);
+
+// Function to call arbiter_step every period_us, never returns
+void arbiter_run(BehaviourArbiter *arbiter);
+
+#endif // BEHAVIOUR_ARBITER_H
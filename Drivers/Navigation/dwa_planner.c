@@ -0,0 +1,213 @@
+#include "dwa_planner.h"
+#include <math.h>
+
+#define DWA_PRUNE_RADIUS_CM (DWA_LOOKAHEAD_CM + DWA_ROBOT_RADIUS_CM)
+
+// Arcs are followed in fixed point so the inner loop needs no soft-float calls:
+// positions in 1/256 cm, the direction of travel as a Q14 unit vector
+#define DWA_POSITION_ONE 256
+#define DWA_UNIT_BITS    14
+#define DWA_ARC_STEPS    ((int)(DWA_LOOKAHEAD_CM / DWA_ARC_STEP_CM))
+#define DWA_STEP_Q       ((int32_t)(DWA_ARC_STEP_CM * DWA_POSITION_ONE))
+#define DWA_RADIUS_Q     ((int32_t)(DWA_ROBOT_RADIUS_CM * DWA_POSITION_ONE))
+#define DWA_UNIT_ROUND   (1 << (DWA_UNIT_BITS - 1))  // Rounds instead of flooring so left and right arcs stay mirror images
+
+// Obstacle in the robot frame, x ahead and y to the left, with its distance from the robot
+typedef struct {
+    int32_t x_q;
+    int32_t y_q;
+    int32_t distance_q;
+} DwaLocalPoint;
+
+// Function to clear the obstacle memory and the last command
+void dwa_init(DwaPlanner *planner) {
+    planner->count = 0;
+    planner->next = 0;
+    planner->speed_cm_s = 0.0f;
+    planner->yaw_rate_rad_s = 0.0f;
+}
+
+// Function to centre the next window on the command the robot is actually following
+void dwa_seed(DwaPlanner *planner, float speed_cm_s, float yaw_rate_rad_s) {
+    planner->speed_cm_s = fmaxf(0.0f, speed_cm_s);  // Only forward arcs are searched, reversing counts as stopped
+    planner->yaw_rate_rad_s = yaw_rate_rad_s;
+}
+
+static void add_point(DwaPlanner *planner, float x_cm, float y_cm) {
+    planner->obstacles[planner->next].x_cm = x_cm;
+    planner->obstacles[planner->next].y_cm = y_cm;
+    planner->next = (planner->next + 1) % DWA_MAX_OBSTACLES;
+    if (planner->count < DWA_MAX_OBSTACLES) {
+        planner->count++;
+    }
+}
+
+// Function to add an echo seen from a pose
+void dwa_add_range(DwaPlanner *planner, const Pose *pose, float sensor_offset_cm, float sensor_angle_rad,
+                   float range_cm) {
+    if (range_cm <= 0.0f || range_cm >= DWA_MAX_RANGE_CM) {
+        return;
+    }
+
+    float sensor_x = pose->x_cm + sensor_offset_cm * cosf(pose->heading_rad);
+    float sensor_y = pose->y_cm + sensor_offset_cm * sinf(pose->heading_rad);
+
+    // The echo could come from anywhere in the cone, so assume the whole arc is blocked
+    for (int i = -1; i <= 1; i++) {
+        float angle = pose->heading_rad + sensor_angle_rad + i * DWA_BEAM_HALF_ANGLE_RAD;
+        add_point(planner, sensor_x + range_cm * cosf(angle), sensor_y + range_cm * sinf(angle));
+    }
+}
+
+// Function to move the obstacles that could be reached this plan into the robot frame, nearest first
+static int prune_obstacles(const DwaPlanner *planner, const Pose *pose, DwaLocalPoint *local) {
+    float c = cosf(pose->heading_rad);
+    float s = sinf(pose->heading_rad);
+    int count = 0;
+
+    for (int i = 0; i < planner->count; i++) {
+        float dx = planner->obstacles[i].x_cm - pose->x_cm;
+        float dy = planner->obstacles[i].y_cm - pose->y_cm;
+        float distance_sq = dx * dx + dy * dy;
+        if (distance_sq >= DWA_PRUNE_RADIUS_CM * DWA_PRUNE_RADIUS_CM) {
+            continue;
+        }
+
+        // Insertion sort, at most DWA_MAX_OBSTACLES points
+        int32_t distance = (int32_t)lroundf(sqrtf(distance_sq) * DWA_POSITION_ONE);
+        int j = count++;
+        while (j > 0 && local[j - 1].distance_q > distance) {
+            local[j] = local[j - 1];
+            j--;
+        }
+        local[j].x_q = (int32_t)lroundf((c * dx + s * dy) * DWA_POSITION_ONE);
+        local[j].y_q = (int32_t)lroundf((c * dy - s * dx) * DWA_POSITION_ONE);
+        local[j].distance_q = distance;
+    }
+    return count;
+}
+
+// Function to follow the arc of a command and return how far along it the robot stays clear.
+// The horizon point is where the robot is after horizon_cm of travel.
+static float free_arc_length(const DwaLocalPoint *local, int count, float speed, float yaw_rate, float horizon_cm,
+                             float *horizon_x, float *horizon_y) {
+    // Rotate the direction of travel by a fixed angle each step instead of calling cosf/sinf per step
+    float step_angle = yaw_rate / speed * DWA_ARC_STEP_CM;
+    int32_t rotate_c = (int32_t)lroundf(cosf(step_angle) * (1 << DWA_UNIT_BITS));
+    int32_t rotate_s = (int32_t)lroundf(sinf(step_angle) * (1 << DWA_UNIT_BITS));
+    int32_t ux = 1 << DWA_UNIT_BITS;
+    int32_t uy = 0;
+    int32_t x = 0;
+    int32_t y = 0;
+    int horizon_steps = (int)(horizon_cm / DWA_ARC_STEP_CM);
+    int reachable = 0;  // Obstacles near enough to touch the robot by this point of the arc
+    float free_cm = DWA_LOOKAHEAD_CM;
+
+    for (int step = 1; step <= DWA_ARC_STEPS; step++) {
+        int32_t next_ux = (ux * rotate_c - uy * rotate_s + DWA_UNIT_ROUND) >> DWA_UNIT_BITS;
+        uy = (ux * rotate_s + uy * rotate_c + DWA_UNIT_ROUND) >> DWA_UNIT_BITS;
+        ux = next_ux;
+        x += (DWA_STEP_Q * ux + DWA_UNIT_ROUND) >> DWA_UNIT_BITS;
+        y += (DWA_STEP_Q * uy + DWA_UNIT_ROUND) >> DWA_UNIT_BITS;
+        if (step <= horizon_steps) {
+            *horizon_x = (float)x / DWA_POSITION_ONE;
+            *horizon_y = (float)y / DWA_POSITION_ONE;
+        }
+
+        // After s cm of travel the robot is at most s from the start, so only
+        // obstacles within s plus its radius can be hit
+        int32_t reach = step * DWA_STEP_Q + DWA_RADIUS_Q;
+        while (reachable < count && local[reachable].distance_q < reach) {
+            reachable++;
+        }
+        for (int i = 0; i < reachable; i++) {
+            int32_t dx = local[i].x_q - x;
+            int32_t dy = local[i].y_q - y;
+            if (dx >= DWA_RADIUS_Q || dx <= -DWA_RADIUS_Q || dy >= DWA_RADIUS_Q || dy <= -DWA_RADIUS_Q) {
+                continue;
+            }
+            if (dx * dx + dy * dy < DWA_RADIUS_Q * DWA_RADIUS_Q) {
+                free_cm = (step - 1) * DWA_ARC_STEP_CM;
+                break;
+            }
+        }
+        if (free_cm < DWA_LOOKAHEAD_CM) {
+            break;  // The rest of the arc cannot change the result
+        }
+    }
+    return free_cm;
+}
+
+// Function to choose the best reachable (speed, yaw rate) for the next control period
+bool dwa_plan(DwaPlanner *planner, const Pose *pose, float goal_x_cm, float goal_y_cm, float dt_s,
+              float *speed_cm_s, float *yaw_rate_rad_s) {
+    // Dynamic window: commands reachable from the last one within one control period
+    float speed_min = fmaxf(0.0f, planner->speed_cm_s - DWA_ACCEL_CM_S2 * dt_s);
+    float speed_max = fminf(DWA_MAX_SPEED_CM_S, planner->speed_cm_s + DWA_ACCEL_CM_S2 * dt_s);
+    float yaw_min = fmaxf(-DWA_MAX_YAW_RATE_RAD_S, planner->yaw_rate_rad_s - DWA_YAW_ACCEL_RAD_S2 * dt_s);
+    float yaw_max = fminf(DWA_MAX_YAW_RATE_RAD_S, planner->yaw_rate_rad_s + DWA_YAW_ACCEL_RAD_S2 * dt_s);
+
+    // Everything below works in the robot frame on the few obstacles that are in reach
+    DwaLocalPoint local[DWA_MAX_OBSTACLES];
+    int count = prune_obstacles(planner, pose, local);
+    float c = cosf(pose->heading_rad);
+    float s = sinf(pose->heading_rad);
+    float goal_x = c * (goal_x_cm - pose->x_cm) + s * (goal_y_cm - pose->y_cm);
+    float goal_y = c * (goal_y_cm - pose->y_cm) - s * (goal_x_cm - pose->x_cm);
+
+    // Turning in place goes nowhere, it only gets credit for the room around the robot
+    float turn_free_cm = DWA_LOOKAHEAD_CM;
+    if (count > 0) {
+        turn_free_cm = fmaxf(0.0f, (float)local[0].distance_q / DWA_POSITION_ONE - DWA_ROBOT_RADIUS_CM);
+    }
+
+    float best_score = -1.0f;
+    float best_speed = 0.0f;
+    float best_yaw = 0.0f;
+
+    for (int i = 0; i < DWA_SPEED_SAMPLES; i++) {
+        float speed = speed_min + (speed_max - speed_min) * i / (DWA_SPEED_SAMPLES - 1);
+        float horizon_cm = speed * DWA_HORIZON_S;
+
+        for (int j = 0; j < DWA_YAW_SAMPLES; j++) {
+            float yaw_rate = yaw_min + (yaw_max - yaw_min) * j / (DWA_YAW_SAMPLES - 1);
+
+            float horizon_x = 0.0f;
+            float horizon_y = 0.0f;
+            float free_cm = turn_free_cm;
+            if (speed > 0.0f) {
+                free_cm = free_arc_length(local, count, speed, yaw_rate, horizon_cm, &horizon_x, &horizon_y);
+            }
+
+            // Admissible only if the robot can still stop within the free part of the arc
+            if (free_cm < horizon_cm || speed * speed > 2.0f * DWA_ACCEL_CM_S2 * free_cm) {
+                continue;
+            }
+
+            // Heading term: 1 pointing at the goal at the end of the horizon, 0 facing away
+            float to_goal = atan2f(goal_y - horizon_y, goal_x - horizon_x);
+            float heading_score = 1.0f - fabsf(odometry_wrap_angle(to_goal - yaw_rate * DWA_HORIZON_S)) / (float)M_PI;
+
+            float score = DWA_WEIGHT_HEADING * heading_score +
+                          DWA_WEIGHT_CLEARANCE * free_cm / DWA_LOOKAHEAD_CM +
+                          DWA_WEIGHT_SPEED * speed / DWA_MAX_SPEED_CM_S;
+            if (score > best_score) {
+                best_score = score;
+                best_speed = speed;
+                best_yaw = yaw_rate;
+            }
+        }
+    }
+
+    // Nothing safe: stop and turn in place towards open space on the next periods
+    if (best_score < 0.0f) {
+        best_speed = 0.0f;
+        best_yaw = (yaw_max > -yaw_min) ? yaw_max : yaw_min;
+    }
+
+    planner->speed_cm_s = best_speed;
+    planner->yaw_rate_rad_s = best_yaw;
+    *speed_cm_s = best_speed;
+    *yaw_rate_rad_s = best_yaw;
+    return best_score >= 0.0f;
+}
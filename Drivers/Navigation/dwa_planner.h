@@ -0,0 +1,64 @@
+// dwa_planner.h
+
+#ifndef DWA_PLANNER_H
+#define DWA_PLANNER_H
+
+#include "odometry.h"
+
+// Robot limits
+#define DWA_MAX_SPEED_CM_S      50.0f
+#define DWA_MAX_YAW_RATE_RAD_S  3.0f
+#define DWA_ACCEL_CM_S2         80.0f
+#define DWA_YAW_ACCEL_RAD_S2    8.0f
+#define DWA_ROBOT_RADIUS_CM     10.0f
+
+// Search. Arcs are checked in fixed point against only the obstacles within reach, so a plan
+// costs about 0.6M cycles (5 ms at 125 MHz) in the worst case of all 48 points close in front,
+// and far less in open space. That leaves room in a 20 ms control period; Ultrasonic_comp
+// reports the measured time.
+#define DWA_SPEED_SAMPLES   7
+#define DWA_YAW_SAMPLES     11
+#define DWA_HORIZON_S       1.0f   // Time the heading to the goal is judged at
+#define DWA_LOOKAHEAD_CM    80.0f  // Arc length checked for obstacles
+#define DWA_ARC_STEP_CM     2.0f
+
+// Score weights: facing the goal, free distance along the arc, driving fast
+#define DWA_WEIGHT_HEADING    0.8f
+#define DWA_WEIGHT_CLEARANCE  1.0f
+#define DWA_WEIGHT_SPEED      0.4f
+
+// Echo points remembered in the odometry frame, the oldest is overwritten
+#define DWA_MAX_OBSTACLES       48
+#define DWA_BEAM_HALF_ANGLE_RAD 0.26f  // HC-SR04 cone, each echo is spread across it
+#define DWA_MAX_RANGE_CM        200.0f
+
+typedef struct {
+    float x_cm;
+    float y_cm;
+} DwaPoint;
+
+typedef struct {
+    DwaPoint obstacles[DWA_MAX_OBSTACLES];
+    int count;
+    int next;
+    float speed_cm_s;     // Command the robot is following, the window is built around it
+    float yaw_rate_rad_s;
+} DwaPlanner;
+
+// Function to clear the obstacle memory and the last command
+void dwa_init(DwaPlanner *planner);
+
+// Function to centre the next window on the command the robot is actually following,
+// which differs from the planner's own last choice whenever another behaviour took over
+void dwa_seed(DwaPlanner *planner, float speed_cm_s, float yaw_rate_rad_s);
+
+// Function to add an echo seen from a pose by a sensor pointing sensor_angle_rad off the heading
+void dwa_add_range(DwaPlanner *planner, const Pose *pose, float sensor_offset_cm, float sensor_angle_rad,
+                   float range_cm);
+
+// Function to choose the best reachable (speed, yaw rate) for the next control period.
+// Returns false if every command in the window collides; the output is then a stop in place.
+bool dwa_plan(DwaPlanner *planner, const Pose *pose, float goal_x_cm, float goal_y_cm, float dt_s,
+              float *speed_cm_s, float *yaw_rate_rad_s);
+
+#endif // DWA_PLANNER_H
@@ -0,0 +1,68 @@
+#include "motion_executor.h"
+#include "motion.h"
+#include "odometry.h"
+#include <math.h>
+
+// Function to get the length of a primitive in the units progress is measured in
+static float primitive_length(const MotionPrimitive* primitive) {
+    return (primitive->type == PRIMITIVE_STRAIGHT) ? primitive->distance_cm : fabsf(primitive->angle_rad);
+}
+
+// Function to start running a primitive sequence
+void motion_executor_start(MotionExecutor* executor, const MotionPrimitive* primitives, int count,
+                           const SpeedProfile* profile) {
+    executor->primitives = primitives;
+    executor->profile = profile;
+    executor->count = count;
+    executor->index = 0;
+    executor->progress = 0.0f;
+}
+
+// Function to advance with the wheel travel since the last call and command the motors
+bool motion_executor_update(MotionExecutor* executor, float left_cm, float right_cm) {
+    if (executor->index >= executor->count) {
+        motion_stop();
+        return false;
+    }
+
+    // Measure progress the way the current primitive is specified
+    const MotionPrimitive* current = &executor->primitives[executor->index];
+    if (current->type == PRIMITIVE_STRAIGHT) {
+        executor->progress += 0.5f * (left_cm + right_cm);
+    } else {
+        executor->progress += fabsf(right_cm - left_cm) / ODOMETRY_TRACK_WIDTH_CM;
+    }
+
+    // Hand any overshoot to the following primitive. Units differ between straights
+    // and turns, so overshoot only carries between primitives of the same kind.
+    while (executor->progress >= primitive_length(current)) {
+        float overshoot = executor->progress - primitive_length(current);
+        executor->index++;
+        if (executor->index >= executor->count) {
+            motion_stop();
+            return false;
+        }
+        const MotionPrimitive* next = &executor->primitives[executor->index];
+        executor->progress = (next->type == current->type) ? overshoot : 0.0f;
+        current = next;
+    }
+
+    // Speed from the profile at the distance covered so far, or the fixed primitive speed
+    float speed = current->speed_cm_s;
+    if (executor->profile != NULL) {
+        float distance = (current->type == PRIMITIVE_STRAIGHT) ? executor->progress
+                                                               : executor->progress * current->radius_cm;
+        speed = speed_profile_speed(executor->profile, executor->index, distance);
+    }
+
+    if (current->type == PRIMITIVE_STRAIGHT) {
+        motion_set_velocity(speed, 0.0f);
+    } else if (current->radius_cm > 0.0f) {
+        // Arc at the segment speed, turn rate follows from the radius
+        float rate = speed / current->radius_cm;
+        motion_set_velocity(speed, current->angle_rad > 0.0f ? rate : -rate);
+    } else {
+        motion_set_velocity(0.0f, current->angle_rad > 0.0f ? EXECUTOR_SPIN_RATE_RAD_S : -EXECUTOR_SPIN_RATE_RAD_S);
+    }
+    return true;
+}
@@ -0,0 +1,31 @@
+// motion_executor.h
+
+#ifndef MOTION_EXECUTOR_H
+#define MOTION_EXECUTOR_H
+
+#include "path_compiler.h"
+#include "speed_profile.h"
+
+#define EXECUTOR_SPIN_RATE_RAD_S  3.0f  // Rotation speed for turns in place
+
+// Runs a primitive sequence from wheel odometry, moving straight on to the next
+// primitive without stopping. Distance past the end of one primitive counts
+// towards the next.
+typedef struct {
+    const MotionPrimitive* primitives;
+    const SpeedProfile* profile;  // Optional, replaces the fixed primitive speeds
+    int count;
+    int index;
+    float progress;  // cm or rad completed in the current primitive
+} MotionExecutor;
+
+// Function to start running a primitive sequence. With a profile the speed is taken from it
+// at every step, otherwise each primitive runs at its own speed_cm_s.
+void motion_executor_start(MotionExecutor* executor, const MotionPrimitive* primitives, int count,
+                           const SpeedProfile* profile);
+
+// Function to advance with the wheel travel since the last call and command the motors.
+// Call at the control rate. Returns false once the sequence is finished and the robot stopped.
+bool motion_executor_update(MotionExecutor* executor, float left_cm, float right_cm);
+
+#endif // MOTION_EXECUTOR_H
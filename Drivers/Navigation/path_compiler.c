@@ -0,0 +1,70 @@
+#include "path_compiler.h"
+#include <math.h>
+
+// Function to find the direction from a cell to an adjacent one
+static int direction_between(GridCell from, GridCell to) {
+    for (int dir = GRID_NORTH; dir <= GRID_WEST; dir++) {
+        if (grid_neighbour(from, dir) == to) {
+            return dir;
+        }
+    }
+    return -1;
+}
+
+// Function to append a primitive, merging a straight into a straight before it
+static int emit(MotionPrimitive* primitives, int count, int max_primitives, MotionPrimitive primitive) {
+    if (primitive.type == PRIMITIVE_STRAIGHT) {
+        if (primitive.distance_cm <= 0.0f) {
+            return count;
+        }
+        if (count > 0 && primitives[count - 1].type == PRIMITIVE_STRAIGHT) {
+            primitives[count - 1].distance_cm += primitive.distance_cm;
+            return count;
+        }
+    }
+    if (count < max_primitives) {
+        primitive.speed_cm_s = PATH_DEFAULT_SPEED_CM_S;
+        primitives[count++] = primitive;
+    }
+    return count;
+}
+
+// Function to turn a cell path into motion primitives
+int path_compile(const GridPath* path, int start_heading, bool smooth,
+                 MotionPrimitive* primitives, int max_primitives) {
+    int count = 0;
+    int heading = start_heading & 3;
+    float straight = 0.0f;  // Distance owed to the current straight
+
+    for (uint16_t i = 1; i < path->length; i++) {
+        int dir = direction_between(path->cells[i - 1], path->cells[i]);
+        if (dir < 0) {
+            break;
+        }
+
+        // Grid directions run clockwise, turn angles counter-clockwise
+        int delta = (dir - heading) & 3;
+        if (delta != 0) {
+            MotionPrimitive turn = {
+                .type = PRIMITIVE_TURN,
+                .angle_rad = (delta == 1) ? -(float)M_PI_2 : (delta == 3) ? (float)M_PI_2 : (float)M_PI,
+                .radius_cm = 0.0f
+            };
+
+            // The first move has no straight in front of it to cut the corner from
+            if (smooth && delta != 2 && i > 1) {
+                turn.radius_cm = PATH_TURN_RADIUS_CM;
+                straight -= PATH_TURN_RADIUS_CM;
+            }
+            count = emit(primitives, count, max_primitives,
+                         (MotionPrimitive){.type = PRIMITIVE_STRAIGHT, .distance_cm = straight});
+            count = emit(primitives, count, max_primitives, turn);
+            straight = (turn.radius_cm > 0.0f) ? -PATH_TURN_RADIUS_CM : 0.0f;
+            heading = dir;
+        }
+        straight += PATH_CELL_SIZE_CM;
+    }
+
+    return emit(primitives, count, max_primitives,
+                (MotionPrimitive){.type = PRIMITIVE_STRAIGHT, .distance_cm = straight});
+}
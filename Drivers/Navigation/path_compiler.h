@@ -0,0 +1,37 @@
+// path_compiler.h
+
+#ifndef PATH_COMPILER_H
+#define PATH_COMPILER_H
+
+#include "path_planner.h"
+
+#ifndef PATH_CELL_SIZE_CM
+#define PATH_CELL_SIZE_CM 25.0f  // Distance between cell centres
+#endif
+#define PATH_TURN_RADIUS_CM  (PATH_CELL_SIZE_CM / 2.0f)  // Smooth turns cut the corner of the cell
+#define PATH_MAX_PRIMITIVES  (2 * GRID_MAP_CELLS)
+#define PATH_DEFAULT_SPEED_CM_S 30.0f  // Speed given to every primitive until a speed profile is applied
+
+typedef enum {
+    PRIMITIVE_STRAIGHT,
+    PRIMITIVE_TURN
+} PrimitiveType;
+
+// One motion segment. A turn with radius 0 is made in place.
+typedef struct {
+    PrimitiveType type;
+    float distance_cm;  // Straight: length driven
+    float angle_rad;    // Turn: counter-clockwise positive
+    float radius_cm;    // Turn: radius of the arc followed by the robot centre
+    float speed_cm_s;   // Forward speed on this segment, PATH_DEFAULT_SPEED_CM_S unless changed
+} MotionPrimitive;
+
+// Function to turn a cell path into motion primitives, starting with the robot facing start_heading.
+// Runs of cells in the same direction become one straight. With smooth set, 90 degree turns
+// become arcs that take half a cell from the straights either side, so the robot never stops;
+// otherwise, and for 180 degree turns, the robot turns in place.
+// Returns the number of primitives written, at most max_primitives.
+int path_compile(const GridPath* path, int start_heading, bool smooth,
+                 MotionPrimitive* primitives, int max_primitives);
+
+#endif // PATH_COMPILER_H
@@ -0,0 +1,87 @@
+#include "grid_map.h"
+#include "map_cache.h"
+#include "path_planner.h"
+#include "path_compiler.h"
+#include "motion_executor.h"
+#include "speed_profile.h"
+#include "motion.h"
+#include "odometry.h"
+#include <stdio.h>
+
+// Define constants for wheel encoder pins
+#define LEFT_WHEEL_ENCODER  28
+#define RIGHT_WHEEL_ENCODER 27
+
+#define CONTROL_PERIOD_US 20000  // Executor runs at 50 Hz
+
+// Limits measured on the robot, braking is gentler than accelerating to avoid wheel slip
+static const SpeedLimits limits = {
+    .max_speed_cm_s = 55.0f,
+    .accel_cm_s2 = 80.0f,
+    .decel_cm_s2 = 60.0f,
+    .lateral_accel_cm_s2 = 100.0f
+};
+
+static GridMap map;
+static PathPlanner planner;
+static GridPath path;
+static MotionPrimitive primitives[PATH_MAX_PRIMITIVES];
+static SpeedProfile profile;
+
+int main() {
+    stdio_init_all();
+    motion_init();
+    odometry_init(LEFT_WHEEL_ENCODER, RIGHT_WHEEL_ENCODER);
+
+    // The test course is identified by a fixed name here; on the track it is the
+    // barcode characters read at the start line
+    MapFingerprint fingerprint;
+    map_cache_fingerprint_init(&fingerprint);
+    for (const char *c = "TEST"; *c; c++) {
+        map_cache_fingerprint_add(&fingerprint, *c);
+    }
+
+    // Reuse the stored map of this course, otherwise lay out the test course and store it:
+    // a wall across the middle with a gap at the east end
+    GridCell start = grid_cell(0, 0);
+    int heading = GRID_NORTH;
+    if (map_cache_load(&map, &fingerprint, &start, &heading)) {
+        printf("Loaded stored map\n");
+    } else {
+        grid_map_init(&map);
+        for (int x = 0; x < GRID_MAP_WIDTH - 1; x++) {
+            grid_map_set_wall(&map, grid_cell(x, 1), GRID_NORTH, true);
+        }
+        map_cache_save(&map, &fingerprint, start, heading);
+    }
+
+    if (!path_planner_shortest(&planner, &map, start, grid_cell(0, 2), &path)) {
+        printf("No path to the goal\n");
+        return 0;
+    }
+    int count = path_compile(&path, heading, true, primitives, PATH_MAX_PRIMITIVES);
+    printf("Path of %d cells compiled to %d primitives\n", path.length, count);
+
+    // Drive as fast as the limits allow instead of at one constant speed
+    speed_profile_plan(&profile, primitives, count, &limits);
+    printf("Profiled drive time %.2f s\n", speed_profile_duration(&profile));
+
+    MotionExecutor executor;
+    motion_executor_start(&executor, primitives, count, &profile);
+
+    absolute_time_t next_step = get_absolute_time();
+    bool running = true;
+    while (running) {
+        next_step = delayed_by_us(next_step, CONTROL_PERIOD_US);
+
+        float left_cm, right_cm;
+        odometry_take_increments(&left_cm, &right_cm);
+        running = motion_executor_update(&executor, left_cm, right_cm);
+        motion_control_update(CONTROL_PERIOD_US / 1000000.0f);
+
+        sleep_until(next_step);
+    }
+
+    printf("Route finished\n");
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "speed_profile.h"
+#include <math.h>
+
+// Function to get the top speed a primitive allows
+static float primitive_cap(const MotionPrimitive* primitive, const SpeedLimits* limits) {
+    if (primitive->type == PRIMITIVE_STRAIGHT) {
+        return limits->max_speed_cm_s;
+    }
+    if (primitive->radius_cm <= 0.0f) {
+        return 0.0f;
+    }
+    return fminf(limits->max_speed_cm_s, sqrtf(limits->lateral_accel_cm_s2 * primitive->radius_cm));
+}
+
+// Function to get the distance the robot centre travels in a primitive
+static float primitive_distance(const MotionPrimitive* primitive) {
+    if (primitive->type == PRIMITIVE_STRAIGHT) {
+        return primitive->distance_cm;
+    }
+    return fabsf(primitive->angle_rad) * primitive->radius_cm;
+}
+
+// Function to compute the profile with a forward and a backward pass
+void speed_profile_plan(SpeedProfile* profile, const MotionPrimitive* primitives, int count,
+                        const SpeedLimits* limits) {
+    profile->limits = *limits;
+    profile->count = count;
+
+    for (int i = 0; i < count; i++) {
+        profile->cap[i] = primitive_cap(&primitives[i], limits);
+        profile->length[i] = primitive_distance(&primitives[i]);
+    }
+
+    // A boundary cannot be faster than the primitives either side of it
+    profile->boundary[0] = 0.0f;
+    profile->boundary[count] = 0.0f;
+    for (int i = 1; i < count; i++) {
+        profile->boundary[i] = fminf(profile->cap[i - 1], profile->cap[i]);
+    }
+
+    // Forward pass: speed reachable by accelerating from the previous boundary
+    for (int i = 0; i < count; i++) {
+        float reachable = sqrtf(profile->boundary[i] * profile->boundary[i] +
+                                2.0f * limits->accel_cm_s2 * profile->length[i]);
+        profile->boundary[i + 1] = fminf(profile->boundary[i + 1], reachable);
+    }
+
+    // Backward pass: speed from which the next boundary can still be reached by braking
+    for (int i = count - 1; i >= 0; i--) {
+        float stoppable = sqrtf(profile->boundary[i + 1] * profile->boundary[i + 1] +
+                                2.0f * limits->decel_cm_s2 * profile->length[i]);
+        profile->boundary[i] = fminf(profile->boundary[i], stoppable);
+    }
+}
+
+// Function to get the target speed a given distance into a primitive
+float speed_profile_speed(const SpeedProfile* profile, int index, float distance_cm) {
+    if (index < 0 || index >= profile->count) {
+        return 0.0f;
+    }
+
+    float length = profile->length[index];
+    float entry = profile->boundary[index];
+    float exit = profile->boundary[index + 1];
+    float done = fminf(fmaxf(distance_cm, 0.0f), length);
+
+    float speed = fminf(profile->cap[index],
+                        fminf(sqrtf(entry * entry + 2.0f * profile->limits.accel_cm_s2 * done),
+                              sqrtf(exit * exit + 2.0f * profile->limits.decel_cm_s2 * (length - done))));
+
+    // Turns in place have no forward speed, everything else must keep moving
+    if (profile->cap[index] > 0.0f && speed < SPEED_PROFILE_MIN_SPEED_CM_S) {
+        speed = SPEED_PROFILE_MIN_SPEED_CM_S;
+    }
+    return speed;
+}
+
+// Function to get the time the profile takes to drive, ignoring turns in place
+float speed_profile_duration(const SpeedProfile* profile) {
+    float total = 0.0f;
+
+    // Integrate dt = ds / v over each primitive in small steps
+    for (int i = 0; i < profile->count; i++) {
+        if (profile->length[i] <= 0.0f) {
+            continue;
+        }
+        int steps = (int)(profile->length[i] / 0.5f) + 1;
+        float step = profile->length[i] / steps;
+        for (int k = 0; k < steps; k++) {
+            total += step / speed_profile_speed(profile, i, (k + 0.5f) * step);
+        }
+    }
+    return total;
+}
@@ -0,0 +1,38 @@
+// speed_profile.h
+
+#ifndef SPEED_PROFILE_H
+#define SPEED_PROFILE_H
+
+#include "path_compiler.h"
+
+#define SPEED_PROFILE_MIN_SPEED_CM_S 8.0f  // Below this the motors stall, so starts and stops use it
+
+// Limits the profile must respect
+typedef struct {
+    float max_speed_cm_s;
+    float accel_cm_s2;
+    float decel_cm_s2;
+    float lateral_accel_cm_s2;  // Cornering limit, sets the speed on arcs as sqrt(a * r)
+} SpeedLimits;
+
+// Fastest speed at every point of a compiled path that respects the limits
+typedef struct {
+    SpeedLimits limits;
+    int count;
+    float cap[PATH_MAX_PRIMITIVES];            // Top speed inside each primitive
+    float length[PATH_MAX_PRIMITIVES];         // Distance the robot centre travels in each primitive
+    float boundary[PATH_MAX_PRIMITIVES + 1];   // Speed at the start of each primitive, and at the end
+} SpeedProfile;
+
+// Function to compute the profile with a forward (acceleration) and backward (braking) pass
+// over the primitive boundaries. The robot starts and ends at rest and stops for turns in place.
+void speed_profile_plan(SpeedProfile* profile, const MotionPrimitive* primitives, int count,
+                        const SpeedLimits* limits);
+
+// Function to get the target speed a given distance into a primitive
+float speed_profile_speed(const SpeedProfile* profile, int index, float distance_cm);
+
+// Function to get the time the profile takes to drive, ignoring turns in place
+float speed_profile_duration(const SpeedProfile* profile);
+
+#endif // SPEED_PROFILE_H
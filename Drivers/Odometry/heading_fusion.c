@@ -0,0 +1,52 @@
+#include "heading_fusion.h"
+#include "odometry.h"
+#include <math.h>
+
+// Reset the filter, the first magnetometer reading initialises it
+void heading_fusion_init(HeadingFusion *fusion) {
+    fusion->initialised = false;
+    fusion->yaw_rad = 0.0f;
+    fusion->variance = 0.0f;
+    fusion->rejected = 0;
+}
+
+// Add the encoder-derived yaw change and distance driven since the last step
+void heading_fusion_predict(HeadingFusion *fusion, float yaw_delta_rad, float travel_cm) {
+    if (!fusion->initialised) {
+        return;
+    }
+    fusion->yaw_rad = odometry_wrap_angle(fusion->yaw_rad + yaw_delta_rad);
+    fusion->variance += HEADING_FUSION_TURN_NOISE * fabsf(yaw_delta_rad) +
+                        HEADING_FUSION_TRAVEL_NOISE * fabsf(travel_cm);
+}
+
+// Correct with a magnetometer yaw
+bool heading_fusion_correct(HeadingFusion *fusion, float mag_yaw_rad) {
+    if (!fusion->initialised) {
+        fusion->initialised = true;
+        fusion->yaw_rad = odometry_wrap_angle(mag_yaw_rad);
+        fusion->variance = HEADING_FUSION_MAG_NOISE;
+        return true;
+    }
+
+    // Innovation on the circle, so 179 and -179 degrees are 2 degrees apart
+    float innovation = odometry_wrap_angle(mag_yaw_rad - fusion->yaw_rad);
+    float innovation_variance = fusion->variance + HEADING_FUSION_MAG_NOISE;
+
+    // Near the motors or steel the field is bent, rely on the encoders until it settles.
+    // The variance keeps growing meanwhile, so a lasting offset is eventually accepted.
+    if (innovation * innovation > HEADING_FUSION_GATE_SIGMA * HEADING_FUSION_GATE_SIGMA * innovation_variance) {
+        fusion->rejected++;
+        return false;
+    }
+
+    float gain = fusion->variance / innovation_variance;
+    fusion->yaw_rad = odometry_wrap_angle(fusion->yaw_rad + gain * innovation);
+    fusion->variance *= (1.0f - gain);
+    return true;
+}
+
+// Convert a compass heading (clockwise, centidegrees) to a yaw in radians
+float heading_fusion_yaw_from_compass(int32_t heading_cdeg) {
+    return odometry_wrap_angle(-(float)heading_cdeg * ((float)M_PI / 18000.0f));
+}
@@ -0,0 +1,36 @@
+// heading_fusion.h
+
+#ifndef HEADING_FUSION_H
+#define HEADING_FUSION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HEADING_FUSION_RATE_HZ      50
+#define HEADING_FUSION_TURN_NOISE   0.01f    // Variance (rad^2) added per radian of encoder yaw: wheel slip in turns
+#define HEADING_FUSION_TRAVEL_NOISE 0.00002f // Variance (rad^2) added per cm driven: uneven wheel wear and slip
+#define HEADING_FUSION_MAG_NOISE    0.0025f  // Variance (rad^2) of a magnetometer heading, ~3 degrees
+#define HEADING_FUSION_GATE_SIGMA   3.0f     // Magnetometer readings further than this are treated as disturbed
+
+// Scalar Kalman filter on yaw: encoder yaw increments drive the prediction,
+// magnetometer headings correct it. Yaw is counter-clockwise from magnetic north.
+typedef struct {
+    bool initialised;
+    float yaw_rad;       // Fused yaw in -pi..pi
+    float variance;      // Variance of the estimate in rad^2
+    uint32_t rejected;   // Magnetometer readings rejected by the gate
+} HeadingFusion;
+
+// Reset the filter, the first magnetometer reading initialises it
+void heading_fusion_init(HeadingFusion *fusion);
+
+// Add the encoder-derived yaw change and distance driven since the last step
+void heading_fusion_predict(HeadingFusion *fusion, float yaw_delta_rad, float travel_cm);
+
+// Correct with a magnetometer yaw, returns false if the reading was rejected as disturbed
+bool heading_fusion_correct(HeadingFusion *fusion, float mag_yaw_rad);
+
+// Convert a compass heading (clockwise, centidegrees) to a yaw in radians
+float heading_fusion_yaw_from_compass(int32_t heading_cdeg);
+
+#endif // HEADING_FUSION_H
@@ -0,0 +1,68 @@
+#include "odometry.h"
+#include "heading_fusion.h"
+#include "imu_sampler.h"
+#include "mag_calibration.h"
+#include "heading.h"
+#include <stdio.h>
+#include <math.h>
+
+// Define constants for wheel encoder pins
+#define LEFT_WHEEL_ENCODER  28
+#define RIGHT_WHEEL_ENCODER 27
+
+int main() {
+    stdio_init_all();
+
+    LSM303 lsm303 = {
+        .i2c = i2c0,
+        .mag_address = MAGNETOMETER_I2C_ADDR,
+        .accel_address = ACCELEROMETER_I2C_ADDR
+    };
+    custom_i2c_init(lsm303.i2c, 0, 1);
+    imu_sampler_start(&lsm303);
+    odometry_init(LEFT_WHEEL_ENCODER, RIGHT_WHEEL_ENCODER);
+
+    MagCalibration cal;
+    if (!mag_calibration_load(&cal)) {
+        printf("No magnetometer calibration stored, heading will be poor near the motors\n");
+        mag_calibration_identity(&cal);
+    }
+
+    HeadingFusion fusion;
+    heading_fusion_init(&fusion);
+    Pose pose = {0};
+    uint32_t last_sample_time = 0;
+    uint32_t count = 0;
+
+    // Fuse at a fixed rate, the encoder prediction runs every step and the magnetometer
+    // corrects whenever the sampler has produced a new reading
+    absolute_time_t next_step = get_absolute_time();
+    while (1) {
+        next_step = delayed_by_us(next_step, 1000000 / HEADING_FUSION_RATE_HZ);
+
+        float left_cm, right_cm;
+        odometry_take_increments(&left_cm, &right_cm);
+        heading_fusion_predict(&fusion, (right_cm - left_cm) / ODOMETRY_TRACK_WIDTH_CM, 0.5f * fabsf(left_cm + right_cm));
+
+        ImuSample sample;
+        if (imu_sampler_latest(&sample) && sample.timestamp_us != last_sample_time) {
+            last_sample_time = sample.timestamp_us;
+            LSM303Vector mag;
+            mag_calibration_apply(&cal, &sample.mag, &mag);
+            heading_fusion_correct(&fusion, heading_fusion_yaw_from_compass(heading_tilt_compensated(&mag, &sample.accel)));
+        }
+
+        // Dead reckoning with the fused heading instead of the encoder-only one
+        odometry_integrate(&pose, left_cm, right_cm);
+        pose.heading_rad = fusion.yaw_rad;
+
+        if (++count % HEADING_FUSION_RATE_HZ == 0) {
+            printf("Yaw: %.1f deg, Std: %.2f deg, X: %.1f cm, Y: %.1f cm, Rejected: %lu\n",
+                   fusion.yaw_rad * 180.0f / (float)M_PI, sqrtf(fusion.variance) * 180.0f / (float)M_PI,
+                   pose.x_cm, pose.y_cm, (unsigned long)fusion.rejected);
+        }
+        sleep_until(next_step);
+    }
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "landmarks.h"
+#include <math.h>
+#include <stddef.h>
+
+// Function to clear the registry and set how strongly repeat sightings correct the pose
+void landmark_registry_init(LandmarkRegistry *registry, float gain) {
+    registry->count = 0;
+    registry->gain = gain;
+}
+
+// Function to look up a label, NULL if it has not been seen
+const Landmark *landmark_find(const LandmarkRegistry *registry, char label) {
+    for (int i = 0; i < registry->count; i++) {
+        if (registry->landmarks[i].label == label) {
+            return &registry->landmarks[i];
+        }
+    }
+    return NULL;
+}
+
+// Function to record a decoded label at the current pose
+bool landmark_observe(LandmarkRegistry *registry, char label, Pose *pose) {
+    Landmark *landmark = (Landmark *)landmark_find(registry, label);
+
+    // First sighting: this is the reference, odometry has drifted least on the first pass
+    if (landmark == NULL) {
+        if (registry->count < LANDMARK_MAX) {
+            Landmark *added = &registry->landmarks[registry->count++];
+            added->label = label;
+            added->pose = *pose;
+            added->sightings = 1;
+        }
+        return false;
+    }
+    landmark->sightings++;
+
+    // Barcodes are read along the direction of travel, so the position is good in any
+    // direction but the heading only compares when passing the same way
+    pose->x_cm += registry->gain * (landmark->pose.x_cm - pose->x_cm);
+    pose->y_cm += registry->gain * (landmark->pose.y_cm - pose->y_cm);
+
+    float heading_error = odometry_wrap_angle(landmark->pose.heading_rad - pose->heading_rad);
+    if (fabsf(heading_error) < LANDMARK_HEADING_WINDOW) {
+        pose->heading_rad = odometry_wrap_angle(pose->heading_rad + registry->gain * heading_error);
+    }
+    return true;
+}
@@ -0,0 +1,34 @@
+// landmarks.h
+
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include "odometry.h"
+
+#define LANDMARK_MAX            16
+#define LANDMARK_HEADING_WINDOW 0.785f  // Only correct heading if passing the same way, within 45 degrees
+
+// A barcode label and where odometry placed the robot when it was first decoded
+typedef struct {
+    char label;
+    Pose pose;
+    uint16_t sightings;
+} Landmark;
+
+typedef struct {
+    Landmark landmarks[LANDMARK_MAX];
+    int count;
+    float gain;  // Share of the error removed on a repeat sighting, 1.0 resets the pose
+} LandmarkRegistry;
+
+// Function to clear the registry and set how strongly repeat sightings correct the pose
+void landmark_registry_init(LandmarkRegistry *registry, float gain);
+
+// Function to record a decoded label at the current pose. The first sighting stores the pose;
+// later sightings pull the pose back towards it. Returns true if the pose was corrected.
+bool landmark_observe(LandmarkRegistry *registry, char label, Pose *pose);
+
+// Function to look up a label, NULL if it has not been seen
+const Landmark *landmark_find(const LandmarkRegistry *registry, char label);
+
+#endif // LANDMARKS_H
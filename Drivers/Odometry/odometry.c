@@ -0,0 +1,108 @@
+#include "odometry.h"
+#include "gpio_dispatch.h"
+#include <math.h>
+
+// Encoder state for one wheel, updated from its interrupt
+typedef struct {
+    uint pin;
+    volatile int32_t notches;      // Signed notch count, direction from the motor code
+    volatile int8_t direction;
+    volatile uint32_t last_edge_us;
+    volatile uint32_t period_us;   // Time between the last two notches, 0 until two are seen
+    int32_t taken;                 // Count at the last odometry_take_increments
+} WheelEncoder;
+
+static WheelEncoder left_wheel;
+static WheelEncoder right_wheel;
+
+// Interrupt callback for one wheel encoder, applies debounce logic
+static void handle_notch(uint gpio, uint32_t events, void *context) {
+    WheelEncoder *wheel = (WheelEncoder *)context;
+    uint32_t now = time_us_32();
+
+    // Ignore events occurring within the debounce period
+    if (now - wheel->last_edge_us < ODOMETRY_DEBOUNCE_US) {
+        return;
+    }
+    wheel->period_us = (wheel->last_edge_us != 0) ? now - wheel->last_edge_us : 0;
+    wheel->last_edge_us = now;
+    wheel->notches += wheel->direction;
+}
+
+// Count notches on both wheel encoders
+void odometry_init(uint left_encoder_pin, uint right_encoder_pin) {
+    WheelEncoder *wheels[] = {&left_wheel, &right_wheel};
+    uint pins[] = {left_encoder_pin, right_encoder_pin};
+
+    for (int i = 0; i < 2; i++) {
+        wheels[i]->pin = pins[i];
+        wheels[i]->notches = 0;
+        wheels[i]->direction = 1;
+        wheels[i]->last_edge_us = 0;
+        wheels[i]->period_us = 0;
+        wheels[i]->taken = 0;
+
+        gpio_init(pins[i]);
+        gpio_set_dir(pins[i], GPIO_IN);
+        gpio_dispatch_register(pins[i], GPIO_IRQ_EDGE_FALL, &handle_notch, wheels[i]);
+    }
+}
+
+// Encoders cannot tell direction, the motor code reports it
+void odometry_set_direction(int left_direction, int right_direction) {
+    left_wheel.direction = (left_direction < 0) ? -1 : 1;
+    right_wheel.direction = (right_direction < 0) ? -1 : 1;
+}
+
+// Distance each wheel has travelled since the previous call
+void odometry_take_increments(float *left_cm, float *right_cm) {
+    int32_t left = left_wheel.notches;
+    int32_t right = right_wheel.notches;
+    *left_cm = (left - left_wheel.taken) * ODOMETRY_CM_PER_NOTCH;
+    *right_cm = (right - right_wheel.taken) * ODOMETRY_CM_PER_NOTCH;
+    left_wheel.taken = left;
+    right_wheel.taken = right;
+}
+
+// Speed of one wheel from the time between its last notches
+static float wheel_speed(const WheelEncoder *wheel, uint32_t now) {
+    uint32_t last_edge = wheel->last_edge_us;
+    uint32_t period = wheel->period_us;
+    uint32_t since_edge = now - last_edge;
+
+    if (period == 0 || since_edge > ODOMETRY_SPEED_TIMEOUT_US) {
+        return 0.0f;
+    }
+    // A wheel that is slowing down has not produced its next notch yet,
+    // so the time since the last one bounds the period from below
+    if (since_edge > period) {
+        period = since_edge;
+    }
+    return wheel->direction * ODOMETRY_CM_PER_NOTCH * 1000000.0f / period;
+}
+
+// Signed speed of each wheel in cm/s
+void odometry_wheel_speeds(float *left_cm_s, float *right_cm_s) {
+    uint32_t now = time_us_32();
+    *left_cm_s = wheel_speed(&left_wheel, now);
+    *right_cm_s = wheel_speed(&right_wheel, now);
+}
+
+// Wrap an angle into -pi..pi
+float odometry_wrap_angle(float angle_rad) {
+    while (angle_rad > (float)M_PI) angle_rad -= 2.0f * (float)M_PI;
+    while (angle_rad < -(float)M_PI) angle_rad += 2.0f * (float)M_PI;
+    return angle_rad;
+}
+
+// Advance a pose by one pair of wheel increments
+void odometry_integrate(Pose *pose, float left_cm, float right_cm) {
+    float distance = 0.5f * (left_cm + right_cm);
+    float turn = (right_cm - left_cm) / ODOMETRY_TRACK_WIDTH_CM;
+
+    // Move along the average heading of the step
+    float mid_heading = pose->heading_rad + 0.5f * turn;
+    pose->x_cm += distance * cosf(mid_heading);
+    pose->y_cm += distance * sinf(mid_heading);
+    pose->heading_rad = odometry_wrap_angle(pose->heading_rad + turn);
+}
@@ -0,0 +1,40 @@
+// odometry.h
+
+#ifndef ODOMETRY_H
+#define ODOMETRY_H
+
+#include "pico/stdlib.h"
+
+#define TOTAL_NOTCHES_PER_REVOLUTION 20     // Total number of notches in one wheel revolution
+#define WHEEL_CIRCUMFERENCE_CM       21.0f  // Wheel circumference in centimeters
+#define ODOMETRY_CM_PER_NOTCH        (WHEEL_CIRCUMFERENCE_CM / TOTAL_NOTCHES_PER_REVOLUTION)
+#define ODOMETRY_TRACK_WIDTH_CM      11.5f  // Distance between the wheel contact points
+#define ODOMETRY_DEBOUNCE_US         1000   // Ignore encoder edges closer together than this
+#define ODOMETRY_SPEED_TIMEOUT_US    250000 // No notch for this long means the wheel has stopped
+
+// Position and heading in the map frame, heading counter-clockwise from the X axis
+typedef struct {
+    float x_cm;
+    float y_cm;
+    float heading_rad;
+} Pose;
+
+// Count notches on both wheel encoders through the GPIO dispatch table
+void odometry_init(uint left_encoder_pin, uint right_encoder_pin);
+
+// Encoders cannot tell direction, the motor code reports it: +1 forward, -1 backward
+void odometry_set_direction(int left_direction, int right_direction);
+
+// Distance each wheel has travelled since the previous call
+void odometry_take_increments(float *left_cm, float *right_cm);
+
+// Signed speed of each wheel in cm/s, from the time between notches
+void odometry_wheel_speeds(float *left_cm_s, float *right_cm_s);
+
+// Advance a pose by one pair of wheel increments (midpoint integration)
+void odometry_integrate(Pose *pose, float left_cm, float right_cm);
+
+// Wrap an angle into -pi..pi
+float odometry_wrap_angle(float angle_rad);
+
+#endif // ODOMETRY_H
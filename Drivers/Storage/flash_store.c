@@ -0,0 +1,81 @@
+#include "flash_store.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+// Header written in front of every record
+typedef struct {
+    uint32_t magic;
+    uint32_t record_id;
+    uint32_t length;
+    uint32_t crc;
+} FlashRecordHeader;
+
+_Static_assert(sizeof(FlashRecordHeader) == FLASH_STORE_HEADER_SIZE, "FLASH_STORE_HEADER_SIZE is out of date");
+
+// CRC-32 (IEEE 802.3) of a buffer, bitwise to avoid a 1 KB table in RAM
+uint32_t flash_store_crc32(uint32_t crc, const void *data, size_t length) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+// Erase the sector at offset and write a record with a CRC-protected header
+bool flash_store_save(uint32_t offset, uint32_t record_id, const void *data, size_t length) {
+    // Anything longer would spill into the next slot
+    if (length > FLASH_STORE_MAX_LENGTH || offset % FLASH_SECTOR_SIZE != 0 ||
+        offset + FLASH_SECTOR_SIZE > PICO_FLASH_SIZE_BYTES) {
+        return false;
+    }
+
+    FlashRecordHeader header = {
+        .magic = FLASH_STORE_MAGIC,
+        .record_id = record_id,
+        .length = length,
+        .crc = flash_store_crc32(0, data, length),
+    };
+    size_t total = sizeof(header) + length;
+
+    uint32_t interrupts = save_and_disable_interrupts();
+    flash_range_erase(offset, FLASH_SECTOR_SIZE);
+
+    // Program one page at a time from a small buffer so large records do not need a RAM copy
+    static uint8_t page[FLASH_PAGE_SIZE];
+    const uint8_t *source = (const uint8_t *)data;
+    size_t written = 0;
+    while (written < total) {
+        memset(page, 0xFF, sizeof(page));
+        for (size_t i = 0; i < FLASH_PAGE_SIZE && written + i < total; i++) {
+            size_t position = written + i;
+            page[i] = (position < sizeof(header)) ? ((const uint8_t *)&header)[position]
+                                                  : source[position - sizeof(header)];
+        }
+        flash_range_program(offset + written, page, FLASH_PAGE_SIZE);
+        written += FLASH_PAGE_SIZE;
+    }
+    restore_interrupts(interrupts);
+    return true;
+}
+
+// Copy a record back if the magic, identifier, length and CRC all match
+bool flash_store_load(uint32_t offset, uint32_t record_id, void *data, size_t length) {
+    // Flash is memory mapped through XIP, so the record can be read in place
+    const uint8_t *stored = (const uint8_t *)(XIP_BASE + offset);
+    FlashRecordHeader header;
+    memcpy(&header, stored, sizeof(header));
+
+    if (header.magic != FLASH_STORE_MAGIC || header.record_id != record_id || header.length != length ||
+        length > FLASH_STORE_MAX_LENGTH) {
+        return false;
+    }
+    if (flash_store_crc32(0, stored + sizeof(header), length) != header.crc) {
+        return false;
+    }
+    memcpy(data, stored + sizeof(header), length);
+    return true;
+}
@@ -0,0 +1,36 @@
+// flash_store.h
+
+#ifndef FLASH_STORE_H
+#define FLASH_STORE_H
+
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+
+// Sectors reserved at the end of flash, counted back from the last one so the program image is never touched.
+// The slots are one sector apart, so a record and its header must fit in a single sector.
+#define FLASH_STORE_MAG_CAL_OFFSET (PICO_FLASH_SIZE_BYTES - 1 * FLASH_SECTOR_SIZE)
+#define FLASH_STORE_MAP_OFFSET     (PICO_FLASH_SIZE_BYTES - 2 * FLASH_SECTOR_SIZE)
+#define FLASH_STORE_IR_CAL_OFFSET  (PICO_FLASH_SIZE_BYTES - 3 * FLASH_SECTOR_SIZE)
+
+#define FLASH_STORE_MAGIC 0x53303954u // "T90S"
+
+#define FLASH_STORE_HEADER_SIZE 16  // Magic, record identifier, length and CRC in front of each record
+#define FLASH_STORE_MAX_LENGTH  (FLASH_SECTOR_SIZE - FLASH_STORE_HEADER_SIZE)
+
+// Record identifiers, stored in the header so one sector can never be read back as another record
+#define FLASH_RECORD_MAG_CAL 0x4D414743u // "MAGC"
+#define FLASH_RECORD_MAP     0x4D415053u // "MAPS"
+#define FLASH_RECORD_IR_CAL  0x4952434Cu // "IRCL"
+
+// Erase the sector at offset and write a record with a CRC-protected header.
+// Returns false if the record is longer than FLASH_STORE_MAX_LENGTH.
+// Interrupts are disabled while flash is busy; the other core must not be running from flash.
+bool flash_store_save(uint32_t offset, uint32_t record_id, const void *data, size_t length);
+
+// Copy a record back if the magic, identifier, length and CRC all match
+bool flash_store_load(uint32_t offset, uint32_t record_id, void *data, size_t length);
+
+// CRC-32 (IEEE 802.3) of a buffer, continuing from a previous value (start with 0)
+uint32_t flash_store_crc32(uint32_t crc, const void *data, size_t length);
+
+#endif // FLASH_STORE_H
@@ -0,0 +1,95 @@
+#include "obstacle_brake.h"
+#include <math.h>
+
+// Initialise the controller with the given standoff distance and cruise speed
+void obstacle_brake_init(ObstacleBrake *brake, float standoff_cm, float max_speed_cm_s) {
+    brake->standoff_cm = standoff_cm;
+    brake->max_decel_cm_s2 = OBSTACLE_BRAKE_MAX_DECEL_CM_S2;
+    brake->max_accel_cm_s2 = OBSTACLE_BRAKE_MAX_ACCEL_CM_S2;
+    brake->max_speed_cm_s = max_speed_cm_s;
+
+    brake->has_range = false;
+    brake->range_cm = OBSTACLE_BRAKE_MAX_RANGE_CM;
+    brake->range_time_us = 0;
+    brake->range_rate_cm_s = 0.0f;
+
+    brake->closing_speed_cm_s = 0.0f;
+    brake->ttc_s = INFINITY;
+    brake->command_cm_s = 0.0f;
+    brake->command_time_us = 0;
+}
+
+// Feed a new ultrasonic range reading taken at timestamp_us
+void obstacle_brake_update_range(ObstacleBrake *brake, float range_cm, uint32_t timestamp_us) {
+    // A missing or out-of-range echo means nothing is in front of the sensor
+    if (range_cm <= 0.0f || range_cm > OBSTACLE_BRAKE_MAX_RANGE_CM) {
+        range_cm = OBSTACLE_BRAKE_MAX_RANGE_CM;
+    }
+
+    if (!brake->has_range) {
+        brake->range_cm = range_cm;
+        brake->range_time_us = timestamp_us;
+        brake->range_rate_cm_s = 0.0f;
+        brake->has_range = true;
+        return;
+    }
+
+    float dt_s = (float)(timestamp_us - brake->range_time_us) / 1000000.0f;
+    if (dt_s <= 0.0f) {
+        return;
+    }
+
+    // Low-pass the range, then differentiate the filtered value to get the closing speed
+    float filtered = brake->range_cm + OBSTACLE_BRAKE_RANGE_ALPHA * (range_cm - brake->range_cm);
+    float rate = (brake->range_cm - filtered) / dt_s;
+    brake->range_rate_cm_s += OBSTACLE_BRAKE_RANGE_ALPHA * (rate - brake->range_rate_cm_s);
+    brake->range_cm = filtered;
+    brake->range_time_us = timestamp_us;
+}
+
+// Compute the forward speed to command given the encoder-measured speed of the robot
+float obstacle_brake_command(ObstacleBrake *brake, float encoder_speed_cm_s, uint32_t timestamp_us) {
+    float allowed = brake->max_speed_cm_s;
+
+    // Take the faster of the two closing estimates: the encoders cover static obstacles
+    // with no lag, the range history also catches obstacles moving towards the robot
+    float closing = brake->range_rate_cm_s;
+    if (encoder_speed_cm_s > closing) {
+        closing = encoder_speed_cm_s;
+    }
+    brake->closing_speed_cm_s = closing;
+
+    if (brake->has_range) {
+        // Advance the last reading to the present so a stale echo does not hide the approach
+        float age_s = (float)(timestamp_us - brake->range_time_us) / 1000000.0f;
+        float gap_cm = brake->range_cm - brake->standoff_cm;
+        if (closing > 0.0f) {
+            gap_cm -= closing * age_s;
+        }
+
+        if (gap_cm <= 0.0f) {
+            allowed = 0.0f;
+            brake->ttc_s = 0.0f;
+        } else {
+            brake->ttc_s = (closing > 0.0f) ? gap_cm / closing : INFINITY;
+
+            // Highest speed from which the robot can still stop within the remaining gap
+            float stopping_speed = sqrtf(2.0f * brake->max_decel_cm_s2 * gap_cm);
+            if (stopping_speed < allowed) {
+                allowed = stopping_speed;
+            }
+        }
+    }
+
+    // Braking follows the envelope directly; speeding back up is rate limited
+    float dt_s = (float)(timestamp_us - brake->command_time_us) / 1000000.0f;
+    brake->command_time_us = timestamp_us;
+    if (allowed > brake->command_cm_s) {
+        float ramped = brake->command_cm_s + brake->max_accel_cm_s2 * dt_s;
+        brake->command_cm_s = (ramped < allowed) ? ramped : allowed;
+    } else {
+        brake->command_cm_s = allowed;
+    }
+
+    return brake->command_cm_s;
+}
@@ -0,0 +1,45 @@
+// obstacle_brake.h
+
+#ifndef OBSTACLE_BRAKE_H
+#define OBSTACLE_BRAKE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Default tuning for the obstacle brake controller
+#define OBSTACLE_BRAKE_STANDOFF_CM      10.0f  // Distance from the obstacle at which the robot should be at rest
+#define OBSTACLE_BRAKE_MAX_DECEL_CM_S2  60.0f  // Deceleration the wheels can reliably achieve without skidding
+#define OBSTACLE_BRAKE_MAX_ACCEL_CM_S2  40.0f  // Acceleration used when speeding back up after the path clears
+#define OBSTACLE_BRAKE_RANGE_ALPHA      0.5f   // Smoothing factor for the range filter (1.0 = no filtering)
+#define OBSTACLE_BRAKE_MAX_RANGE_CM     400.0f // HC-SR04 readings beyond this are treated as "nothing ahead"
+
+typedef struct {
+    // Configuration
+    float standoff_cm;        // Distance from the obstacle at which the robot should stop
+    float max_decel_cm_s2;    // Deceleration used to shape the braking envelope
+    float max_accel_cm_s2;    // Acceleration limit when the commanded speed rises again
+    float max_speed_cm_s;     // Cruise speed in open space
+
+    // Filtered range history
+    bool     has_range;         // True once the first valid reading has been received
+    float    range_cm;          // Filtered range to the obstacle ahead
+    uint32_t range_time_us;     // Timestamp of the last accepted range reading
+    float    range_rate_cm_s;   // Closing speed derived from the range history (positive = approaching)
+
+    // Controller outputs
+    float closing_speed_cm_s; // Closing speed used for the last decision
+    float ttc_s;              // Time to reach the standoff distance at the current closing speed
+    float command_cm_s;       // Last commanded forward speed
+    uint32_t command_time_us; // Timestamp of the last command, used for the acceleration limit
+} ObstacleBrake;
+
+// Initialise the controller with the given standoff distance and cruise speed
+void obstacle_brake_init(ObstacleBrake *brake, float standoff_cm, float max_speed_cm_s);
+
+// Feed a new ultrasonic range reading taken at timestamp_us
+void obstacle_brake_update_range(ObstacleBrake *brake, float range_cm, uint32_t timestamp_us);
+
+// Compute the forward speed to command given the encoder-measured speed of the robot
+float obstacle_brake_command(ObstacleBrake *brake, float encoder_speed_cm_s, uint32_t timestamp_us);
+
+#endif // OBSTACLE_BRAKE_H
@@ -0,0 +1,80 @@
+#include "range_estimator.h"
+
+// Restart the filter from a single reading
+static void range_estimator_reset(RangeEstimator *est, float measured_cm, uint32_t timestamp_us) {
+    est->initialised = true;
+    est->range_cm = measured_cm;
+    est->variance = RANGE_EST_MEASUREMENT_NOISE;
+    est->time_us = timestamp_us;
+    est->reject_count = 0;
+    est->closer_count = 0;
+}
+
+// Reset the estimator, the first reading initialises it
+void range_estimator_init(RangeEstimator *est) {
+    est->initialised = false;
+    est->range_cm = RANGE_EST_MAX_RANGE_CM;
+    est->variance = 0.0f;
+    est->time_us = 0;
+    est->reject_count = 0;
+    est->closer_count = 0;
+}
+
+// Predict the range after the robot has moved forward_cm towards the obstacle
+void range_estimator_predict(RangeEstimator *est, float forward_cm, uint32_t timestamp_us) {
+    if (!est->initialised) {
+        return;
+    }
+
+    float dt_s = 0.0f;
+    int32_t elapsed_us = (int32_t)(timestamp_us - est->time_us);
+    if (elapsed_us > 0) {
+        dt_s = (float)elapsed_us / 1000000.0f;
+        est->time_us = timestamp_us;
+    }
+
+    // The obstacle is assumed static, so the range shrinks by exactly the distance driven
+    est->range_cm -= forward_cm;
+    if (est->range_cm < 0.0f) {
+        est->range_cm = 0.0f;
+    }
+
+    // Uncertainty grows with distance driven and with time since the last echo
+    float travel = (forward_cm < 0.0f) ? -forward_cm : forward_cm;
+    est->variance += RANGE_EST_TRAVEL_NOISE * travel + RANGE_EST_TIME_NOISE * dt_s;
+}
+
+// Correct the estimate with an ultrasonic reading
+bool range_estimator_correct(RangeEstimator *est, float measured_cm, uint32_t timestamp_us) {
+    if (measured_cm <= 0.0f || measured_cm > RANGE_EST_MAX_RANGE_CM) {
+        measured_cm = RANGE_EST_MAX_RANGE_CM; // No echo means nothing within range
+    }
+
+    if (!est->initialised) {
+        range_estimator_reset(est, measured_cm, timestamp_us);
+        return true;
+    }
+
+    float innovation = measured_cm - est->range_cm;
+    float innovation_variance = est->variance + RANGE_EST_MEASUREMENT_NOISE;
+
+    // Gate outliers, but follow readings that are suddenly much closer (something stepped in front)
+    // once a second one agrees, so a single short echo from cross-talk cannot reset the filter.
+    // Give up on the prediction when the readings persistently disagree with it.
+    float gate = RANGE_EST_GATE_SIGMA * RANGE_EST_GATE_SIGMA * innovation_variance;
+    if (innovation * innovation > gate) {
+        est->closer_count = (innovation < 0.0f) ? est->closer_count + 1 : 0;
+        if (est->closer_count >= RANGE_EST_CLOSER_CONFIRM || ++est->reject_count >= RANGE_EST_MAX_REJECTS) {
+            range_estimator_reset(est, measured_cm, timestamp_us);
+            return true;
+        }
+        return false;
+    }
+
+    float gain = est->variance / innovation_variance;
+    est->range_cm += gain * innovation;
+    est->variance *= (1.0f - gain);
+    est->reject_count = 0;
+    est->closer_count = 0;
+    return true;
+}
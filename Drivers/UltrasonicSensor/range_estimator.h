@@ -0,0 +1,38 @@
+// range_estimator.h
+
+#ifndef RANGE_ESTIMATOR_H
+#define RANGE_ESTIMATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define RANGE_EST_TRAVEL_NOISE      0.05f // Variance (cm^2) added per cm of encoder travel: slip and notch quantisation
+#define RANGE_EST_TIME_NOISE        4.0f  // Variance (cm^2) added per second: obstacle motion and unmodelled effects
+#define RANGE_EST_MEASUREMENT_NOISE 1.0f  // Variance (cm^2) of a single HC-SR04 reading
+#define RANGE_EST_GATE_SIGMA        3.0f  // Readings further than this many sigma from the prediction are suspect
+#define RANGE_EST_MAX_REJECTS       3     // Consecutive suspect readings before the estimate is reset
+#define RANGE_EST_CLOSER_CONFIRM    2     // Consecutive suspect readings all closer than the estimate before it is reset
+#define RANGE_EST_MAX_RANGE_CM      400.0f
+
+// 1-D Kalman filter tracking the range to the obstacle ahead
+typedef struct {
+    bool     initialised;
+    float    range_cm;      // Estimated range to the obstacle
+    float    variance;      // Variance of the estimate in cm^2
+    uint32_t time_us;       // Time of the last predict or correct step
+    uint8_t  reject_count;  // Consecutive readings rejected by the gate
+    uint8_t  closer_count;  // Consecutive rejected readings that were closer than the estimate
+} RangeEstimator;
+
+// Reset the estimator, the first reading initialises it
+void range_estimator_init(RangeEstimator *est);
+
+// Predict the range after the robot has moved forward_cm towards the obstacle (negative when reversing).
+// A timestamp older than the last step adds no time noise and does not move the filter time back.
+void range_estimator_predict(RangeEstimator *est, float forward_cm, uint32_t timestamp_us);
+
+// Correct the estimate with an ultrasonic reading, returns false if the reading was rejected.
+// The estimate must have been predicted up to timestamp_us, the time the echo arrived.
+bool range_estimator_correct(RangeEstimator *est, float measured_cm, uint32_t timestamp_us);
+
+#endif // RANGE_ESTIMATOR_H
@@ -0,0 +1,40 @@
+#include "ultrasonicsensor.h"
+#include "adc_sampler.h"
+#include <stdio.h>
+
+// Define GPIO pins for the HC-SR04 ultrasonic sensors
+#define FRONT_TRIG_PIN 6  // Front sensor trigger pin
+#define FRONT_ECHO_PIN 7  // Front sensor echo pin
+#define SIDE_TRIG_PIN  8  // Side sensor trigger pin
+#define SIDE_ECHO_PIN  9  // Side sensor echo pin
+
+int main() {
+    stdio_init_all();
+    adc_sampler_start(); // Needed for the on-die temperature sensor
+
+    HCSR04 front;
+    HCSR04 side;
+    hcsr04_init(&front, FRONT_TRIG_PIN, FRONT_ECHO_PIN);
+    hcsr04_init(&side, SIDE_TRIG_PIN, SIDE_ECHO_PIN);
+
+    // The scheduler pings the sensors in turn, no manual triggering needed
+    hcsr04_start_ranging();
+
+    while (1) {
+        // Keep the speed of sound in step with the air temperature
+        hcsr04_refresh_air_temperature();
+
+        // Check if a new measurement is available
+        if (front.new_measurement_available) {
+            printf("Front distance: %.2f cm\n", hcsr04_calculate_distance_cm(&front)); // Print the measured distance
+            front.new_measurement_available = false; // Reset the measurement flag
+        }
+        if (side.new_measurement_available) {
+            printf("Side distance: %.2f cm\n", hcsr04_calculate_distance_cm(&side));
+            side.new_measurement_available = false;
+        }
+        tight_loop_contents();
+    }
+
+    return 0;
+}
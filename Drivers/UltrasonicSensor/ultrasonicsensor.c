@@ -1,84 +1,176 @@
-#include "pico/stdlib.h"
-#include "hardware/gpio.h"
+#include "ultrasonicsensor.h"
+#include "gpio_dispatch.h"
 #include "hardware/timer.h"
-#include "hardware/irq.h"
-#include <stdio.h>
-
-// Define GPIO pins for the HC-SR04 ultrasonic sensor
-#define TRIG_PIN 6  // Trigger pin
-#define ECHO_PIN 7  // Echo pin
-
-// Volatile variables to store timestamps and flag for new measurement
-volatile uint32_t start_time = 0;
-volatile uint32_t end_time = 0;
-volatile bool new_measurement_available = false;
-
-// Interrupt Service Routine for the Echo pin
-void echo_isr() {
-    if (gpio_get(ECHO_PIN)) { // Rising edge detected
-        start_time = time_us_32(); // Record time when echo goes high
-    } else { // Falling edge detected
-        end_time = time_us_32(); // Record time when echo goes low
-        new_measurement_available = true; // Set flag for new measurement
+#include "adc_sampler.h"
+
+// Phases of a ranging slot
+typedef enum {
+    RANGING_IDLE,      // Scheduler stopped
+    RANGING_PULSE,     // Trigger pin is high for the current sensor
+    RANGING_LISTEN,    // Waiting for the current sensor's echo before moving on
+} RangingPhase;
+
+// Sensors sharing the scheduler, pinged in registration order so only one is ever in flight
+static HCSR04 *sensors[HCSR04_MAX_SENSORS];
+static uint sensor_count = 0;
+static uint active_sensor = 0;
+
+static int ranging_alarm = -1;                  // Hardware alarm owned by the scheduler
+static volatile RangingPhase phase = RANGING_IDLE;
+static volatile bool stop_requested = false;
+static volatile uint64_t slot_end_time = 0;    // End of the current sensor's listening window
+
+// Echo time to distance scale in mm per microsecond, Q16 fixed point. Covers the round trip,
+// so distance_mm = (echo_us * scale) >> 16. Default is 343.4 m/s (20 C).
+static volatile uint32_t distance_scale_q16 = 11253;
+static float air_temp_c = HCSR04_DEFAULT_AIR_TEMP_C;
+static bool air_temp_valid = false;
+static uint32_t last_temp_refresh_ms = 0;
+
+static void ranging_alarm_callback(uint alarm_num);
+
+// Arm the alarm for an absolute time, running the callback now if the time has already passed
+static void ranging_schedule_at(uint64_t target_us) {
+    if (hardware_alarm_set_target(ranging_alarm, from_us_since_boot(target_us))) {
+        ranging_alarm_callback(ranging_alarm);
     }
 }
 
-// Timer callback function to set trigger pin low
-void timer_callback() {
-    gpio_put(TRIG_PIN, 0); // Set TRIG pin low
-    hw_clear_bits(&timer_hw->intr, 1u << 0); // Disable the timer interrupt
+// Raise the trigger of the active sensor and schedule the end of the pulse
+static void ranging_begin_slot() {
+    uint64_t now = time_us_64();
+    slot_end_time = now + HCSR04_SLOT_US;
+    phase = RANGING_PULSE;
+    gpio_put(sensors[active_sensor]->trig_pin, 1);
+    ranging_schedule_at(now + HCSR04_TRIGGER_PULSE_US);
+}
+
+// Single alarm handler stepping through pulse and listen phases for each sensor in turn
+static void ranging_alarm_callback(uint alarm_num) {
+    if (phase == RANGING_PULSE) {
+        // End of the trigger pulse, listen for the echo until the slot ends
+        gpio_put(sensors[active_sensor]->trig_pin, 0);
+        phase = RANGING_LISTEN;
+        ranging_schedule_at(slot_end_time);
+    } else if (phase == RANGING_LISTEN) {
+        if (stop_requested || sensor_count == 0) {
+            phase = RANGING_IDLE;
+            return;
+        }
+        // Slot finished, hand over to the next sensor
+        active_sensor = (active_sensor + 1) % sensor_count;
+        ranging_begin_slot();
+    }
 }
 
-// Initialize the HC-SR04 sensor
-void hcsr04_init() {
-    gpio_init(TRIG_PIN); // Initialize TRIG pin
-    gpio_set_dir(TRIG_PIN, GPIO_OUT); // Set TRIG pin as output
-    gpio_put(TRIG_PIN, 0); // Set TRIG pin low
+// Configure the pins of a sensor and add it to the ranging schedule
+bool hcsr04_init(HCSR04 *sensor, uint trig_pin, uint echo_pin) {
+    if (sensor_count >= HCSR04_MAX_SENSORS) {
+        return false;
+    }
+
+    sensor->trig_pin = trig_pin;
+    sensor->echo_pin = echo_pin;
+    sensor->start_time = 0;
+    sensor->end_time = 0;
+    sensor->new_measurement_available = false;
 
-    gpio_init(ECHO_PIN); // Initialize ECHO pin
-    gpio_set_dir(ECHO_PIN, GPIO_IN); // Set ECHO pin as input
+    gpio_init(trig_pin); // Initialize TRIG pin
+    gpio_set_dir(trig_pin, GPIO_OUT); // Set TRIG pin as output
+    gpio_put(trig_pin, 0); // Set TRIG pin low
+
+    gpio_init(echo_pin); // Initialize ECHO pin
+    gpio_set_dir(echo_pin, GPIO_IN); // Set ECHO pin as input
 
     // Set up interrupt on ECHO pin for both rising and falling edges
-    gpio_set_irq_enabled_with_callback(ECHO_PIN, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true, &echo_isr);
-}
+    gpio_dispatch_register(echo_pin, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, &echo_isr, sensor);
 
-// Function to trigger a new measurement with the HC-SR04 sensor
-void hcsr04_trigger_measurement() {
-    hw_set_bits(&timer_hw->inte, 1u << 0); // Enable timer interrupt
-    timer_hw->alarm[0] = timer_hw->timerawl + 10; // Set timer for 10 microseconds
-    
-    irq_set_exclusive_handler(TIMER_IRQ_0, timer_callback); // Set timer interrupt handler
-    irq_set_enabled(TIMER_IRQ_0, true); // Enable timer interrupt
+    sensors[sensor_count++] = sensor;
+    return true;
+}
 
-    gpio_put(TRIG_PIN, 1); // Set TRIG pin high
+// Start pinging the registered sensors one after another
+void hcsr04_start_ranging() {
+    if (sensor_count == 0 || phase != RANGING_IDLE) {
+        return;
+    }
+    // Claim an alarm the SDK alarm pool is not using instead of writing alarm 0 directly
+    if (ranging_alarm < 0) {
+        ranging_alarm = hardware_alarm_claim_unused(true);
+        hardware_alarm_set_callback(ranging_alarm, &ranging_alarm_callback);
+    }
+    stop_requested = false;
+    active_sensor = 0;
+    ranging_begin_slot();
 }
 
-// Calculate the distance in centimeters based on time elapsed
-float hcsr04_calculate_distance_cm() {
-    float time_elapsed = (float)(end_time - start_time); // Calculate time difference in microseconds
-    return (time_elapsed * 0.0343) / 2; // Convert time to distance (speed of sound is 343 m/s or 0.0343 cm/us)
+// Stop the ranging schedule after the current slot
+void hcsr04_stop_ranging() {
+    stop_requested = true;
 }
 
-int main() {
-    stdio_init_all(); 
-    hcsr04_init();
+// Interrupt Service Routine for the Echo pin of one sensor
+void echo_isr(uint gpio, uint32_t events, void *context) {
+    HCSR04 *sensor = (HCSR04 *)context;
 
-    uint32_t last_trigger_time = 0; // Variable to track last trigger time
+    if (events & GPIO_IRQ_EDGE_RISE) { // Rising edge detected
+        sensor->start_time = time_us_32(); // Record time when echo goes high
+    } else if (events & GPIO_IRQ_EDGE_FALL) { // Falling edge detected
+        sensor->end_time = time_us_32(); // Record time when echo goes low
+        sensor->new_measurement_available = true; // Set flag for new measurement
 
-    while (1) {
-        // Trigger a new measurement every 500 ms
-        if (time_us_32() - last_trigger_time > 500000) {
-            hcsr04_trigger_measurement();
-            last_trigger_time = time_us_32();
+        // Short echo: start the next sensor after the guard time instead of waiting out the slot
+        if (phase == RANGING_LISTEN && sensors[active_sensor] == sensor) {
+            uint64_t early_end = time_us_64() + HCSR04_GUARD_US;
+            if (early_end < slot_end_time) {
+                slot_end_time = early_end;
+                ranging_schedule_at(early_end);
+            }
         }
+    }
+}
 
-        // Check if a new measurement is available
-        if (new_measurement_available) {
-            float distance = hcsr04_calculate_distance_cm();
-            printf("Distance: %.2f cm\n", distance); // Print the measured distance
-            new_measurement_available = false; // Reset the measurement flag
-        }
+// Set the air temperature used for the speed of sound and precompute the distance scale
+void hcsr04_set_air_temperature(float temp_c) {
+    // Speed of sound in air is 331.3 m/s at 0 C and rises by 0.606 m/s per degree
+    float speed_m_s = 331.3f + 0.606f * temp_c;
+
+    // m/s equals mm/ms, halve for the round trip and convert to mm per microsecond
+    float mm_per_us = speed_m_s / 2000.0f;
+    distance_scale_q16 = (uint32_t)(mm_per_us * 65536.0f + 0.5f);
+    air_temp_c = temp_c;
+}
+
+// Refresh the air temperature from the RP2040 on-die sensor when the refresh interval has passed
+void hcsr04_refresh_air_temperature() {
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    if (!adc_sampler_ready() || (air_temp_valid && now_ms - last_temp_refresh_ms < HCSR04_TEMP_REFRESH_MS)) {
+        return;
     }
+    last_temp_refresh_ms = now_ms;
 
-    return 0;
+    // The sampler converts the temperature sensor continuously, so this never touches the ADC input
+    const float die_temp_c = adc_sampler_temperature_c();
+
+    // Smooth the reading further, the air temperature changes slowly
+    float temp_c = die_temp_c - HCSR04_DIE_TEMP_OFFSET_C;
+    if (air_temp_valid) {
+        temp_c = air_temp_c + 0.25f * (temp_c - air_temp_c);
+    }
+    air_temp_valid = true;
+    hcsr04_set_air_temperature(temp_c);
+}
+
+// Calculate the distance in millimetres from the last echo of a sensor using integer arithmetic only
+uint32_t hcsr04_calculate_distance_mm(const HCSR04 *sensor) {
+    uint32_t time_elapsed = sensor->end_time - sensor->start_time; // Echo width in microseconds
+    if (time_elapsed > HCSR04_MAX_ECHO_US) {
+        time_elapsed = HCSR04_MAX_ECHO_US; // Keeps the product within 32 bits
+    }
+    return (time_elapsed * distance_scale_q16 + 0x8000) >> 16;
+}
+
+// Calculate the distance in centimeters based on time elapsed
+float hcsr04_calculate_distance_cm(const HCSR04 *sensor) {
+    return hcsr04_calculate_distance_mm(sensor) / 10.0f; // Scale includes the temperature-corrected speed of sound
 }
@@ -0,0 +1,58 @@
+// ultrasonicsensor.h
+
+#ifndef ULTRASONICSENSOR_H
+#define ULTRASONICSENSOR_H
+
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+
+#define HCSR04_MAX_SENSORS      4     // Sensors sharing the ranging scheduler
+#define HCSR04_TRIGGER_PULSE_US 10    // Width of the trigger pulse
+#define HCSR04_ECHO_DELAY_US    1000  // Upper bound on the delay from trigger to the echo pin rising
+#define HCSR04_NO_ECHO_US       38000 // Width of the echo pulse when nothing is in range
+#define HCSR04_GUARD_US         5000  // Quiet time after an echo before the next sensor fires
+
+// Time reserved per sensor. Long enough for even a no-echo pulse to end inside the slot with the
+// guard after it; the falling edge of any echo ends the slot early, at the edge plus the guard.
+#define HCSR04_SLOT_US (HCSR04_ECHO_DELAY_US + HCSR04_NO_ECHO_US + HCSR04_GUARD_US)
+
+#define HCSR04_DEFAULT_AIR_TEMP_C 20.0f // Assumed air temperature until the first refresh
+#define HCSR04_DIE_TEMP_OFFSET_C  0.0f  // How much warmer the RP2040 die runs than the surrounding air
+#define HCSR04_TEMP_REFRESH_MS    5000  // Interval between air temperature refreshes
+#define HCSR04_MAX_ECHO_US        60000 // Echoes longer than this are clamped before scaling
+
+// State for one HC-SR04 sensor, written by its echo interrupt
+typedef struct {
+    uint trig_pin;
+    uint echo_pin;
+    volatile uint32_t start_time;              // Time the echo pin went high
+    volatile uint32_t end_time;                // Time the echo pin went low
+    volatile bool new_measurement_available;   // Set by the echo interrupt, cleared by the reader
+} HCSR04;
+
+// Configure the pins of a sensor and add it to the ranging schedule
+bool hcsr04_init(HCSR04 *sensor, uint trig_pin, uint echo_pin);
+
+// Start pinging the registered sensors one after another, claiming a hardware alarm on first use
+void hcsr04_start_ranging();
+
+// Stop the ranging schedule after the current slot
+void hcsr04_stop_ranging();
+
+// Echo interrupt for one sensor, registered through the GPIO dispatch table
+void echo_isr(uint gpio, uint32_t events, void *context);
+
+// Set the air temperature used for the speed of sound and precompute the distance scale
+void hcsr04_set_air_temperature(float temp_c);
+
+// Refresh the air temperature from the RP2040 on-die sensor when the refresh interval has passed.
+// Needs adc_sampler_start(); until the sampler has data the default temperature is kept.
+void hcsr04_refresh_air_temperature();
+
+// Calculate the distance in millimetres from the last echo of a sensor using integer arithmetic only
+uint32_t hcsr04_calculate_distance_mm(const HCSR04 *sensor);
+
+// Calculate the distance in centimeters from the last echo of a sensor
+float hcsr04_calculate_distance_cm(const HCSR04 *sensor);
+
+#endif // ULTRASONICSENSOR_H
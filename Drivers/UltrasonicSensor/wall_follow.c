@@ -0,0 +1,101 @@
+#include "wall_follow.h"
+#include <math.h>
+
+// Function to set up wall following on one side at a target distance
+void wall_follow_init(WallFollower *follower, int side, float target_cm) {
+    follower->side = (side < 0) ? WALL_FOLLOW_RIGHT : WALL_FOLLOW_LEFT;
+    follower->target_cm = target_cm;
+    follower->sample_count = 0;
+    follower->has_range = false;
+    follower->range_cm = 0.0f;
+    follower->range_time_us = 0;
+    follower->reject_count = 0;
+    follower->previous_range_cm = 0.0f;
+    follower->range_rate_cm_s = 0.0f;
+    follower->integral = 0.0f;
+    follower->yaw_rate_rad_s = 0.0f;
+}
+
+static float median3(float a, float b, float c) {
+    if ((a <= b && b <= c) || (c <= b && b <= a)) return b;
+    if ((b <= a && a <= c) || (c <= a && a <= b)) return a;
+    return c;
+}
+
+// Function to feed a side range reading
+bool wall_follow_add_range(WallFollower *follower, float range_cm, uint32_t timestamp_us, float speed_cm_s) {
+    if (range_cm <= 0.0f || range_cm > WALL_FOLLOW_MAX_RANGE_CM) {
+        return false;
+    }
+
+    // Median of three removes single spikes from cross-talk and missed echoes
+    follower->samples[follower->sample_count % 3] = range_cm;
+    follower->sample_count++;
+    float filtered = range_cm;
+    if (follower->sample_count >= 3) {
+        filtered = median3(follower->samples[0], follower->samples[1], follower->samples[2]);
+    }
+
+    // A sudden jump is a gap in the wall or a doorway: keep steering on the old range
+    // until the new one has been seen several times in a row
+    bool jumped = follower->has_range && fabsf(filtered - follower->range_cm) > WALL_FOLLOW_MAX_STEP_CM;
+    if (jumped && ++follower->reject_count < WALL_FOLLOW_MAX_REJECTS) {
+        return false;
+    }
+    follower->reject_count = 0;
+
+    if (!follower->has_range || jumped || timestamp_us - follower->range_time_us > WALL_FOLLOW_LOST_US) {
+        // First reading, a new wall after a jump, or the wall was lost: start the controller
+        // afresh so the step is not taken as a range rate or wound into the integral
+        follower->has_range = true;
+        follower->range_cm = filtered;
+        follower->range_time_us = timestamp_us;
+        follower->previous_range_cm = filtered;
+        follower->range_rate_cm_s = 0.0f;
+        follower->integral = 0.0f;
+        follower->yaw_rate_rad_s = 0.0f;
+        return true;
+    }
+
+    float dt_s = (float)(timestamp_us - follower->range_time_us) / 1000000.0f;
+    if (dt_s <= 0.0f) {
+        return false;
+    }
+    follower->range_cm = filtered;
+    follower->range_time_us = timestamp_us;
+
+    float error = filtered - follower->target_cm;
+    float rate = (filtered - follower->previous_range_cm) / dt_s;
+    follower->previous_range_cm = filtered;
+    follower->range_rate_cm_s += WALL_FOLLOW_RATE_ALPHA * (rate - follower->range_rate_cm_s);
+
+    // Outer loop: too far from the wall asks for a negative angle, closing on it
+    follower->integral += error * dt_s;
+    if (follower->integral > WALL_FOLLOW_INTEGRAL_LIMIT) follower->integral = WALL_FOLLOW_INTEGRAL_LIMIT;
+    if (follower->integral < -WALL_FOLLOW_INTEGRAL_LIMIT) follower->integral = -WALL_FOLLOW_INTEGRAL_LIMIT;
+    float target_angle = -(WALL_FOLLOW_KP * error + WALL_FOLLOW_KI * follower->integral);
+    if (target_angle > WALL_FOLLOW_MAX_ANGLE_RAD) target_angle = WALL_FOLLOW_MAX_ANGLE_RAD;
+    if (target_angle < -WALL_FOLLOW_MAX_ANGLE_RAD) target_angle = -WALL_FOLLOW_MAX_ANGLE_RAD;
+
+    // Inner loop: the range changes at v * sin(angle), which gives the current angle
+    float speed = fmaxf(fabsf(speed_cm_s), WALL_FOLLOW_MIN_SPEED);
+    float ratio = follower->range_rate_cm_s / speed;
+    if (ratio > 1.0f) ratio = 1.0f;
+    if (ratio < -1.0f) ratio = -1.0f;
+    float angle = asinf(ratio);
+
+    // Turning left moves away from a wall on the right and towards a wall on the left
+    float yaw = -follower->side * WALL_FOLLOW_ANGLE_GAIN * speed * (target_angle - angle);
+    if (yaw > WALL_FOLLOW_MAX_YAW_RATE) yaw = WALL_FOLLOW_MAX_YAW_RATE;
+    if (yaw < -WALL_FOLLOW_MAX_YAW_RATE) yaw = -WALL_FOLLOW_MAX_YAW_RATE;
+    follower->yaw_rate_rad_s = yaw;
+    return true;
+}
+
+// Function to get the yaw rate to add to the forward motion
+float wall_follow_yaw_rate(const WallFollower *follower, uint32_t now_us) {
+    if (!follower->has_range || now_us - follower->range_time_us > WALL_FOLLOW_LOST_US) {
+        return 0.0f;
+    }
+    return follower->yaw_rate_rad_s;
+}
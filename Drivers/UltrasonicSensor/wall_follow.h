@@ -0,0 +1,60 @@
+// wall_follow.h
+
+#ifndef WALL_FOLLOW_H
+#define WALL_FOLLOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define WALL_FOLLOW_LEFT   1   // Wall on the left of the robot
+#define WALL_FOLLOW_RIGHT -1   // Wall on the right of the robot
+
+#define WALL_FOLLOW_TARGET_CM      15.0f   // Default distance held from the wall
+#define WALL_FOLLOW_MAX_STEP_CM    12.0f   // A reading this far from the filtered range is a gap or doorway
+#define WALL_FOLLOW_MAX_RANGE_CM   80.0f   // Beyond this there is no wall to follow
+#define WALL_FOLLOW_LOST_US        300000  // No usable reading for this long: stop steering
+#define WALL_FOLLOW_MAX_REJECTS    4       // Consecutive rejected readings before the new range is accepted
+
+// Cascaded control. The outer PI loop turns range error into an angle to close on the wall,
+// limited so the slant range stays close to the true distance. The inner loop steers
+// the angle, estimated from the range rate, to it. The inner gain grows with speed: turning
+// also changes the slant range, and at low speed that would swamp the angle estimate.
+#define WALL_FOLLOW_KP              0.03f   // rad of approach angle per cm of error
+#define WALL_FOLLOW_KI              0.005f  // rad per cm*s
+#define WALL_FOLLOW_INTEGRAL_LIMIT  40.0f   // cm*s
+#define WALL_FOLLOW_MAX_ANGLE_RAD   0.35f   // Steepest approach to or away from the wall, 20 degrees
+#define WALL_FOLLOW_ANGLE_GAIN      0.06f   // rad/s of yaw per rad of angle error, per cm/s of speed
+#define WALL_FOLLOW_RATE_ALPHA      0.5f    // EMA weight of the newest range rate
+#define WALL_FOLLOW_MIN_SPEED       10.0f   // cm/s, below this the angle cannot be estimated
+#define WALL_FOLLOW_MAX_YAW_RATE    1.5f    // rad/s
+
+typedef struct {
+    int side;
+    float target_cm;
+
+    // Range filter: median of the last three readings, gated against jumps
+    float samples[3];
+    int sample_count;
+    bool has_range;
+    float range_cm;
+    uint32_t range_time_us;
+    uint8_t reject_count;
+
+    // Control state, stepped once per accepted reading so the loop runs at the sensor rate
+    float previous_range_cm;
+    float range_rate_cm_s;  // Filtered, positive when moving away from the wall
+    float integral;
+    float yaw_rate_rad_s;
+} WallFollower;
+
+// Function to set up wall following on one side at a target distance
+void wall_follow_init(WallFollower *follower, int side, float target_cm);
+
+// Function to feed a side range reading; returns true if it was accepted and the controller stepped
+bool wall_follow_add_range(WallFollower *follower, float range_cm, uint32_t timestamp_us, float speed_cm_s);
+
+// Function to get the yaw rate to add to the forward motion, counter-clockwise positive.
+// Zero when the wall has been lost.
+float wall_follow_yaw_rate(const WallFollower *follower, uint32_t now_us);
+
+#endif // WALL_FOLLOW_H
@@ -0,0 +1,69 @@
+#include "ultrasonicsensor.h"
+#include "wall_follow.h"
+#include "motion.h"
+#include "odometry.h"
+#include "adc_sampler.h"
+#include "behaviour_arbiter.h"
+#include <stdio.h>
+
+// Side sensor pins, clear of the motor driver pins used by motion.c
+#define SIDE_TRIG_PIN 10
+#define SIDE_ECHO_PIN 11
+
+// Define constants for wheel encoder pins
+#define LEFT_WHEEL_ENCODER  28
+#define RIGHT_WHEEL_ENCODER 27
+
+#define CRUISE_SPEED_CM_S 45.0f
+
+// Wall follower state shared with the arbiter
+typedef struct {
+    HCSR04 side;
+    WallFollower follower;
+} WallTracker;
+
+WallTracker tracker;
+
+// Function to hold the lane against the wall; the controller steps once per echo and the
+// last correction is held in between
+bool wall_behaviour(void *context, uint32_t now_us, BehaviourRequest *request) {
+    WallTracker *t = context;
+    if (t->side.new_measurement_available) {
+        float left_cm_s, right_cm_s;
+        odometry_wheel_speeds(&left_cm_s, &right_cm_s);
+        wall_follow_add_range(&t->follower, hcsr04_calculate_distance_cm(&t->side), t->side.end_time,
+                              0.5f * (left_cm_s + right_cm_s));
+        t->side.new_measurement_available = false;
+    }
+
+    request->linear_cm_s = CRUISE_SPEED_CM_S;
+    request->angular_rad_s = wall_follow_yaw_rate(&t->follower, now_us);
+    return true;
+}
+
+int main() {
+    stdio_init_all();
+    adc_sampler_start(); // Needed for the on-die temperature sensor
+    motion_init();
+    odometry_init(LEFT_WHEEL_ENCODER, RIGHT_WHEEL_ENCODER);
+
+    hcsr04_init(&tracker.side, SIDE_TRIG_PIN, SIDE_ECHO_PIN);
+    hcsr04_start_ranging();
+
+    // Hold the lane against a wall on the right
+    wall_follow_init(&tracker.follower, WALL_FOLLOW_RIGHT, WALL_FOLLOW_TARGET_CM);
+
+    BehaviourArbiter arbiter;
+    arbiter_init(&arbiter);
+    arbiter_add(&arbiter, "wall", BEHAVIOUR_PRIORITY_WALL, BEHAVIOUR_COMMAND, &wall_behaviour, &tracker);
+
+    absolute_time_t next_step = get_absolute_time();
+    while (1) {
+        next_step = delayed_by_us(next_step, arbiter.period_us);
+        hcsr04_refresh_air_temperature();
+        arbiter_step(&arbiter, time_us_32());
+        sleep_until(next_step);
+    }
+
+    return 0;
+}
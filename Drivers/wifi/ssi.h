@@ -1,6 +1,6 @@
 #include "lwip/apps/httpd.h"
 #include "pico/cyw43_arch.h"
-#include "hardware/adc.h"
+#include "adc_sampler.h"
 
 // SSI tags - tag length limited to 8 bytes by default
 const char * ssi_tags[] = {"volt","temp","led"};
@@ -10,14 +10,13 @@ u16_t ssi_handler(int iIndex, char *pcInsert, int iInsertLen) {
   switch (iIndex) {
   case 0: // volt
     {
-      const float voltage = adc_read() * 3.3f / (1 << 12);
+      const float voltage = adc_sampler_volts(ADC_SAMPLER_TEMP);
       printed = snprintf(pcInsert, iInsertLen, "%f", voltage);
     }
     break;
   case 1: // temp
     {
-    const float voltage = adc_read() * 3.3f / (1 << 12);
-    const float tempC = 27.0f - (voltage - 0.706f) / 0.001721f;
+    const float tempC = adc_sampler_temperature_c();
     printed = snprintf(pcInsert, iInsertLen, "%f", tempC);
     }
     break;
@@ -42,10 +41,8 @@ u16_t ssi_handler(int iIndex, char *pcInsert, int iInsertLen) {
 
 // Initialise the SSI handler
 void ssi_init() {
-  // Initialise ADC (internal pin)
-  adc_init();
-  adc_set_temp_sensor_enabled(true);
-  adc_select_input(4);
+  // Sample the ADC in the background, the handler only reads the latest values
+  adc_sampler_start();
 
   http_set_ssi_handler(ssi_handler, ssi_tags, LWIP_ARRAYSIZE(ssi_tags));
 }
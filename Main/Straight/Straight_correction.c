@@ -1,138 +1,55 @@
 // Include necessary headers for Raspberry Pi Pico functionality
 #include "pico/stdlib.h"
-#include "hardware/gpio.h"
-#include "hardware/timer.h"
-#include "hardware/irq.h"
+#include "hardware/adc.h"
 #include <stdio.h>
-
-// Define GPIO pins for motor control and ADC inputs
-#define IN1_PIN 6
-#define IN2_PIN 7
-#define IN3_PIN 4
-#define IN4_PIN 3
-#define EN_A_PIN 8
-#define EN_B_PIN 2
+#include "motion.h"
+#include "ir_line.h"
+#include "line_follow.h"
+#include "ir_calibration.h"
+#include "adc_sampler.h"
+#include "behaviour_arbiter.h"
+
+// Define ADC inputs for the IR sensors
 #define ADC_X_AXIS 27
 #define ADC_Y_AXIS 26
 
-// Define IR sensor threshold value
-#define IR_THRESHOLD 1000
-
-// Define PWM wrap speed and adjustments for left motor speed
-const uint32_t wrap_speed = 64515;
-const float left_adjustments = 0.965;
-
-// Function to move both motors forward
-void move_forward()
-{
-    // Set motor control pins to drive motors forward
-    gpio_put(IN1_PIN, true);
-    gpio_put(IN2_PIN, false);
-    gpio_put(IN3_PIN, false);
-    gpio_put(IN4_PIN, true);
-}
-
-// Function to move both motors backward
-void move_backward()
-{
-    // Set motor control pins to drive motors backward
-    gpio_put(IN1_PIN, false);
-    gpio_put(IN2_PIN, true);
-    gpio_put(IN3_PIN, true);
-    gpio_put(IN4_PIN, false);
-}
-
-// Function to stop all motors
-void stop()
-{
-    // Reset all motor control pins to stop motors
-    gpio_put(IN1_PIN, false);
-    gpio_put(IN2_PIN, false);
-    gpio_put(IN3_PIN, false);
-    gpio_put(IN4_PIN, false);
-}
-
-// Function to move forward with speed adjustments
-void move_forward_both()
-{
-    // Set PWM duty cycle for both motors with adjustments for the left motor
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_A_PIN), wrap_speed * left_adjustments); // left
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_B_PIN), wrap_speed);
-    move_forward();
-}
+// Define line following speed and mode
+#define CRUISE_SPEED_CM_S 40.0f
+#define FOLLOW_MODE LINE_FOLLOW_AWAY_FROM_LINE  // Keep clear of the lines either side, as the timed turns did
+#define PRINT_EVERY 100                          // Print the line offset twice a second
 
-// Function to move backward with speed adjustments
-void move_backwards_both()
+// Line follower state shared with the arbiter
+typedef struct
 {
-    // Set PWM duty cycle for both motors with adjustments for the left motor
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_A_PIN), wrap_speed * left_adjustments); // left
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_B_PIN), wrap_speed);
-    move_backward();
-}
+    LineFollower follower;
+    IrCalibration cal;
+    uint16_t left;   // Last raw readings, kept for printing
+    uint16_t right;
+} LineTracker;
 
-// Function to turn left
-void move_turn_left()
-{
-    // Set PWM duty cycle with turn adjustments and move forward
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_A_PIN), (wrap_speed * left_adjustments) * turn_value); // left
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_B_PIN), wrap_speed);
-    move_forward();
-}
+LineTracker tracker;
 
-// Function to turn right
-void move_turn_right()
+// Steer continuously on the analog line offset and slow down while the line is off centre
+bool line_behaviour(void *context, uint32_t now_us, BehaviourRequest *request)
 {
-    // Set PWM duty cycle with turn adjustments and move forward
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_A_PIN), wrap_speed * left_adjustments); // left
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_B_PIN), wrap_speed * turn_value);
-    move_forward();
-}
+    LineTracker *t = context;
 
-// Function to stop movement
-void move_stop()
-{
-    // Set PWM duty cycle with stop adjustments and move forward
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_A_PIN), wrap_speed * left_adjustments * turn_value); // left
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_B_PIN), wrap_speed * turn_value);
-    move_forward();
-}
+    // Read raw ADC values from both sensors
+    t->left = ir_read_left();
+    t->right = ir_read_right();
 
-// Function to set PWM duty cycle
-void set_duty_cycle(uint slice_num, uint16_t duty_cycle)
-{
-    // Set PWM channel level for specified slice number
-    pwm_set_chan_level(slice_num, PWM_CHAN_A, duty_cycle);
-}
+    // Let the levels follow slow changes in lighting and floor, then hand them to the follower
+    ir_calibration_is_black(&t->cal, LINE_FOLLOW_LEFT, t->left);
+    ir_calibration_is_black(&t->cal, LINE_FOLLOW_RIGHT, t->right);
+    for (int i = 0; i < IR_CAL_CHANNELS; i++)
+    {
+        line_follow_set_levels(&t->follower, i, t->cal.channel[i].white, t->cal.channel[i].black);
+    }
 
-// Initialization function for motor control
-void init_motor_control()
-{
-    // Initialize GPIO pins and set direction for motor control
-    gpio_init(IN1_PIN);
-    gpio_set_dir(IN1_PIN, GPIO_OUT);
-    gpio_init(IN2_PIN);
-    gpio_set_dir(IN2_PIN, GPIO_OUT);
-    gpio_init(IN3_PIN);
-    gpio_set_dir(IN3_PIN, GPIO_OUT);
-    gpio_init(IN4_PIN);
-    gpio_set_dir(IN4_PIN, GPIO_OUT);
-
-    // Initialize PWM for motor speed control and set frequency
-    gpio_set_function(EN_A_PIN, GPIO_FUNC_PWM);
-    gpio_set_function(EN_B_PIN, GPIO_FUNC_PWM);
-    uint slice_num_a = pwm_gpio_to_slice_num(EN_A_PIN);
-    uint slice_num_b = pwm_gpio_to_slice_num(EN_B_PIN);
-    pwm_set_clkdiv_int_frac(slice_num_a, 1, 15);
-    pwm_set_clkdiv_int_frac(slice_num_b, 1, 15);
-    pwm_set_wrap(slice_num_a, 64515);
-    pwm_set_wrap(slice_num_b, 64515);
-    pwm_set_enabled(slice_num_a, true);
-    pwm_set_enabled(slice_num_b, true);
-
-    // Initialize ADC for sensor readings
-    adc_init();
-    adc_gpio_init(ADC_X_AXIS);
-    adc_gpio_init(ADC_Y_AXIS);
+    // Run the PID step at the arbiter rate
+    request->angular_rad_s = line_follow_update(&t->follower, t->left, t->right, LINE_FOLLOW_PERIOD_US / 1000000.0f);
+    request->linear_cm_s = line_follow_speed(&t->follower, CRUISE_SPEED_CM_S);
+    return true;
 }
 
 // Main function
@@ -142,38 +59,45 @@ int main()
     stdio_init_all();
 
     // Initialize motor control
-    init_motor_control();
+    motion_init();
+
+    // Start sampling the ADC in the background for sensor readings
+    adc_sampler_start();
+    adc_gpio_init(ADC_X_AXIS);
+    adc_gpio_init(ADC_Y_AXIS);
+
+    // Use the floor and line levels measured by the IR Line calibration sweep when one is stored
+    if (!ir_calibration_load(&tracker.cal))
+    {
+        printf("No IR calibration stored, using default levels\n");
+        ir_calibration_default(&tracker.cal);
+    }
+    line_follow_init(&tracker.follower, FOLLOW_MODE);
+
+    // The line follower drives through the arbiter at its own rate. The wheel speed loop is
+    // not run: GPIO27 is the right IR sensor here, so the right wheel encoder cannot be used.
+    BehaviourArbiter arbiter;
+    arbiter_init(&arbiter);
+    arbiter.period_us = LINE_FOLLOW_PERIOD_US;
+    arbiter.speed_control = false;
+    arbiter_add(&arbiter, "line", BEHAVIOUR_PRIORITY_LINE, BEHAVIOUR_COMMAND, &line_behaviour, &tracker);
+
+    uint32_t count = 0;
+    absolute_time_t next_step = get_absolute_time();
 
     // Main loop
     while (1)
     {
-        // Default movement - move forward
-        move_forward_both();
+        next_step = delayed_by_us(next_step, arbiter.period_us);
+        arbiter_step(&arbiter, time_us_32());
 
-        // Read ADC values from sensors
-        adc_select_input(0); // Select ADC channel for X-axis sensor
-        uint16_t sensor_value_26 = adc_read();
-        adc_select_input(1); // Select ADC channel for Y-axis sensor
-        uint16_t sensor_value_27 = adc_read();
-
-        // Decision making based on sensor readings
-        if (sensor_value_26 > IR_THRESHOLD)
-        {
-            // If X-axis sensor is above threshold, turn right then left
-            move_turn_right();
-            sleep_ms(150);
-            move_turn_left();
-            sleep_ms(85);
-        }
-        else if (sensor_value_27 > IR_THRESHOLD)
+        if (++count % PRINT_EVERY == 0)
         {
-            // If Y-axis sensor is above threshold, turn left then right
-            move_turn_left();
-            sleep_ms(150);
-            move_turn_right();
-            sleep_ms(85);
+            printf("Left: %u, Right: %u, Offset: %.2f, Yaw: %.2f rad/s\n", tracker.left, tracker.right,
+                   tracker.follower.offset, arbiter.output.angular_rad_s);
         }
+        sleep_until(next_step);
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -1,209 +1,171 @@
 #include "pico/stdlib.h"
-#include "hardware/gpio.h"
-#include "hardware/timer.h"
-#include "hardware/irq.h"
+#include "adc_sampler.h"
 #include <stdio.h>
+#include "ultrasonicsensor.h"
+#include "obstacle_brake.h"
+#include "range_estimator.h"
+#include "dwa_planner.h"
+#include "occupancy_grid.h"
+#include "behaviour_arbiter.h"
+#include "motion.h"
+#include "odometry.h"
 
 
-#define IN1_PIN 6
-#define IN2_PIN 7
-#define IN3_PIN 4
-#define IN4_PIN 3
-#define EN_A_PIN 8
-#define EN_B_PIN 2
 #define TRIG_PIN 0
 #define ECHO_PIN 1
-
-volatile uint32_t start_time = 0;
-volatile uint32_t end_time = 0;
-volatile bool new_measurement_available = false;
-const uint32_t wrap_speed = 64515;
-const float left_adjustments = 0.965;
-
-void move_forward()
+#define WHEEL_ENCODER_1 28
+#define WHEEL_ENCODER_2 27
+
+#define CRUISE_SPEED_CM_S 45.0f    // Speed used when the path ahead is clear
+#define SENSOR_OFFSET_CM 8.0f      // Front sensor distance ahead of the wheel axle
+#define GOAL_DISTANCE_CM 300.0f    // Navigation goal, straight ahead of the start pose
+#define ESCAPE_RANGE_CM 5.0f       // Closer than this the robot backs away
+#define ESCAPE_SPEED_CM_S -15.0f
+#define PRINT_EVERY 25             // Print the arbiter state twice a second
+
+// Everything the behaviours share, updated once per period before the arbiter runs
+typedef struct
 {
-    gpio_put(IN1_PIN, true);
-    gpio_put(IN2_PIN, false);
-    gpio_put(IN3_PIN, false);
-    gpio_put(IN4_PIN, true);
-}
-
-void move_backward()
-{
-    gpio_put(IN1_PIN, false);
-    gpio_put(IN2_PIN, true);
-    gpio_put(IN3_PIN, true);
-    gpio_put(IN4_PIN, false);
-}
-
-void stop()
+    HCSR04 sensor;
+    RangeEstimator range;
+    ObstacleBrake brake;
+    DwaPlanner planner;
+    OccupancyGrid grid;
+    Pose pose;
+    float speed_cm_s;
+    BehaviourRequest command;  // What the arbiter sent to the motors last period
+    uint32_t plan_us;          // Longest DWA plan so far, must stay well inside ARBITER_PERIOD_US
+} Robot;
+
+Robot robot;
+
+// Back away slowly from anything that got inside the standoff
+bool escape_behaviour(void *context, uint32_t now_us, BehaviourRequest *request)
 {
-    gpio_put(IN1_PIN, false);
-    gpio_put(IN2_PIN, false);
-    gpio_put(IN3_PIN, false);
-    gpio_put(IN4_PIN, false);
-}
-
-
-void move_forward_both()
-{
-    // For the first 5 seconds, both motors at normal speed
-    // set_duty_cycle(pwm_gpio_to_slice_num(EN_A_PIN), normal_speed);
-    // set_duty_cycle(pwm_gpio_to_slice_num(EN_B_PIN), normal_speed);
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_A_PIN), wrap_speed * left_adjustments); // left
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_B_PIN), wrap_speed);
-    move_forward();
-    // printf("Forwaard\n");
-}
-
-void move_backwards_both()
-{
-    // For the first 5 seconds, both motors at normal speed
-    // set_duty_cycle(pwm_gpio_to_slice_num(EN_A_PIN), normal_speed);
-    // set_duty_cycle(pwm_gpio_to_slice_num(EN_B_PIN), normal_speed);
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_A_PIN), wrap_speed * left_adjustments); // left
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_B_PIN), wrap_speed);
-    move_backward();
-    // printf("Forwaard\n");
-}
-
-void move_turn_left()
-{
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_A_PIN), (wrap_speed * left_adjustments) * turn_value); // left
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_B_PIN), wrap_speed);
-    move_forward();
-    // printf("Left\n");
-}
-
-void move_turn_right()
-{
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_A_PIN), wrap_speed * left_adjustments); // left
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_B_PIN), wrap_speed * turn_value);
-    move_forward();
-    // printf("right\n");
-}
-
-void move_stop()
-{
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_A_PIN), wrap_speed * left_adjustments * turn_value); // left
-    set_duty_cycle(pwm_gpio_to_slice_num(EN_B_PIN), wrap_speed * turn_value);
-    move_forward();
+    Robot *r = context;
+    if (!r->range.initialised || r->range.range_cm >= ESCAPE_RANGE_CM)
+    {
+        return false;
+    }
+    request->linear_cm_s = ESCAPE_SPEED_CM_S;
+    request->angular_rad_s = 0.0f;
+    return true;
 }
 
-void set_duty_cycle(uint slice_num, uint16_t duty_cycle)
+// Cap forward speed so the robot comes to rest at the standoff distance
+bool brake_behaviour(void *context, uint32_t now_us, BehaviourRequest *request)
 {
-    pwm_set_chan_level(slice_num, PWM_CHAN_A, duty_cycle);
+    Robot *r = context;
+    if (r->range.initialised)
+    {
+        obstacle_brake_update_range(&r->brake, r->range.range_cm, now_us);
+    }
+    request->linear_cm_s = obstacle_brake_command(&r->brake, r->speed_cm_s, now_us);
+    request->angular_rad_s = 0.0f;
+    return true;
 }
 
-void init_motor_control()
+// Head for the goal and steer around echoes on the way
+bool navigate_behaviour(void *context, uint32_t now_us, BehaviourRequest *request)
 {
-    gpio_init(IN1_PIN);
-    gpio_set_dir(IN1_PIN, GPIO_OUT);
-    gpio_init(IN2_PIN);
-    gpio_set_dir(IN2_PIN, GPIO_OUT);
-
-    gpio_init(IN3_PIN);
-    gpio_set_dir(IN3_PIN, GPIO_OUT);
-    gpio_init(IN4_PIN);
-    gpio_set_dir(IN4_PIN, GPIO_OUT);
-
-    // Initialize PWM for EN_A and EN_B
-    gpio_set_function(EN_A_PIN, GPIO_FUNC_PWM);
-    gpio_set_function(EN_B_PIN, GPIO_FUNC_PWM);
-
-    uint slice_num_a = pwm_gpio_to_slice_num(EN_A_PIN);
-    uint slice_num_b = pwm_gpio_to_slice_num(EN_B_PIN);
-    // Set frequency for PWM
-    pwm_set_clkdiv_int_frac(slice_num_a, 1, 15);
-    pwm_set_clkdiv_int_frac(slice_num_b, 1, 15);
-
-    pwm_set_wrap(slice_num_a, 64515);
-    pwm_set_wrap(slice_num_b, 64515);
-    pwm_set_enabled(slice_num_a, true);
-    pwm_set_enabled(slice_num_b, true);
-}
-
-void echo_isr() {
-    if (gpio_get(ECHO_PIN)) { // Rising edge detected
-        start_time = time_us_32();
-    } else { // Falling edge detected
-        end_time = time_us_32();
-        new_measurement_available = true;
+    Robot *r = context;
+    float dx = GOAL_DISTANCE_CM - r->pose.x_cm;
+    float dy = -r->pose.y_cm;
+    if (dx * dx + dy * dy < DWA_ROBOT_RADIUS_CM * DWA_ROBOT_RADIUS_CM)
+    {
+        return false;  // Arrived, nothing else drives so the arbiter stops the robot
     }
-}
-
-void timer_callback() {
-    // Set TRIG pin low
-    gpio_put(TRIG_PIN, 0);
-    
-    // Disable the timer interrupt (single shot)
-    hw_clear_bits(&timer_hw->intr, 1u << 0);
-}
-
-void hcsr04_init() {
-	// Setup GPIO and interrupts for the ultrasonic sensor.
-    gpio_init(TRIG_PIN);
-    gpio_set_dir(TRIG_PIN, GPIO_OUT);
-    gpio_put(TRIG_PIN, 0);
-
-    gpio_init(ECHO_PIN);
-    gpio_set_dir(ECHO_PIN, GPIO_IN);
 
-    // Setup interrupt on ECHO pin for both rising and falling edges
-    gpio_set_irq_enabled_with_callback(ECHO_PIN, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true, &echo_isr);
-}
-
-void hcsr04_trigger_measurement() {
-    // Start the timer interrupt for 10 microseconds
-    uint alarm_num = 0;  // Using timer 0
-    hw_set_bits(&timer_hw->inte, 1u << alarm_num);
-    timer_hw->alarm[alarm_num] = timer_hw->timerawl + 10;  // Set for 10 microseconds from now
-    
-    irq_set_exclusive_handler(TIMER_IRQ_0, timer_callback);
-    irq_set_enabled(TIMER_IRQ_0, true);
-
-    // Set TRIG pin high
-    gpio_put(TRIG_PIN, 1);
-}
-
-
-float hcsr04_calculate_distance_cm() {
-    float time_elapsed = (float)(end_time - start_time);  // Time in microseconds
-    return (time_elapsed * 0.0343) / 2;  // Speed of sound is 343 m/s or 0.0343 cm/us
+    // Build the window around what the robot is really doing, braking or escaping may have overridden the last plan
+    dwa_seed(&r->planner, r->command.linear_cm_s, r->command.angular_rad_s);
+    uint32_t start = time_us_32();
+    dwa_plan(&r->planner, &r->pose, GOAL_DISTANCE_CM, 0.0f, ARBITER_PERIOD_US / 1000000.0f,
+             &request->linear_cm_s, &request->angular_rad_s);
+    uint32_t elapsed = time_us_32() - start;
+    if (elapsed > r->plan_us)
+    {
+        r->plan_us = elapsed;
+    }
+    return true;
 }
 
 int main() {
-	// If an object is detected within 5 cm, move backward; otherwise, move forward.
-}
+    // Drive to a goal while the arbiter lets the obstacle behaviours override navigation
     stdio_init_all();
-    hcsr04_init();
-
-    uint32_t last_trigger_time = 0;
-
+    motion_init();
+    adc_sampler_start();
+    odometry_init(WHEEL_ENCODER_1, WHEEL_ENCODER_2);
+    hcsr04_init(&robot.sensor, TRIG_PIN, ECHO_PIN);
+    hcsr04_start_ranging();
+
+    // Range estimate predicted from the encoders between pings and corrected at each echo
+    range_estimator_init(&robot.range);
+    obstacle_brake_init(&robot.brake, OBSTACLE_BRAKE_STANDOFF_CM, CRUISE_SPEED_CM_S);
+    dwa_init(&robot.planner);
+    occupancy_grid_init(&robot.grid);
+
+    BehaviourArbiter arbiter;
+    arbiter_init(&arbiter);
+    arbiter_add(&arbiter, "escape", BEHAVIOUR_PRIORITY_SAFETY, BEHAVIOUR_COMMAND, &escape_behaviour, &robot);
+    arbiter_add(&arbiter, "brake", BEHAVIOUR_PRIORITY_SAFETY, BEHAVIOUR_LIMIT, &brake_behaviour, &robot);
+    arbiter_add(&arbiter, "navigate", BEHAVIOUR_PRIORITY_NAVIGATION, BEHAVIOUR_COMMAND, &navigate_behaviour, &robot);
+
+    uint32_t count = 0;
+    absolute_time_t next_step = get_absolute_time();
     while (1) {
-        // Trigger a new measurement every 500 ms
-        if (time_us_32() - last_trigger_time > 500000)
-        {
-            hcsr04_trigger_measurement();
-            last_trigger_time = time_us_32();
-        }
-
-        // Check if a new measurement is available
-        if (new_measurement_available)
+        next_step = delayed_by_us(next_step, arbiter.period_us);
+        uint32_t now = time_us_32();
+
+        // Keep the speed of sound in step with the air temperature so braking starts at the right range
+        hcsr04_refresh_air_temperature();
+
+        // Move the pose by the distance driven since the last period
+        float left_cm, right_cm;
+        odometry_take_increments(&left_cm, &right_cm);
+        odometry_integrate(&robot.pose, left_cm, right_cm);
+        float forward_cm = 0.5f * (left_cm + right_cm);
+
+        float left_cm_s, right_cm_s;
+        odometry_wheel_speeds(&left_cm_s, &right_cm_s);
+        robot.speed_cm_s = 0.5f * (left_cm_s + right_cm_s);
+
+        // Correct the range estimate and the obstacle memory with each new echo. The estimate is
+        // predicted to the time the echo arrived first, sharing out the travel at constant speed,
+        // so the reading is compared with the range it actually measured.
+        if (robot.sensor.new_measurement_available)
         {
-            float distance = hcsr04_calculate_distance_cm();
-            printf("Distance: %.2f cm\n", distance);
-
-            if (distance < 5.0)
+            uint32_t echo_us = robot.sensor.end_time;
+            uint32_t period_us = now - robot.range.time_us;
+            float before = 1.0f;
+            if (period_us > 0 && echo_us - robot.range.time_us < period_us)
             {
-                moveBackward();
+                before = (float)(echo_us - robot.range.time_us) / (float)period_us;
             }
-            else
+            range_estimator_predict(&robot.range, before * forward_cm, echo_us);
+            forward_cm -= before * forward_cm;
+
+            float distance = hcsr04_calculate_distance_cm(&robot.sensor);
+            if (range_estimator_correct(&robot.range, distance, echo_us))
             {
-                move_forward_both();
+                // Map the filtered range, readings the estimator gated out are left off the map too
+                occupancy_grid_update(&robot.grid, &robot.pose, robot.range.range_cm);
             }
-            new_measurement_available = false;
+            dwa_add_range(&robot.planner, &robot.pose, SENSOR_OFFSET_CM, 0.0f, distance);
+            robot.sensor.new_measurement_available = false;
+        }
+        range_estimator_predict(&robot.range, forward_cm, now);
+
+        // The arbiter is the only code that drives the motors
+        arbiter_step(&arbiter, now);
+        robot.command = arbiter.output;
+
+        if (++count % PRINT_EVERY == 0)
+        {
+            printf("Estimate: %.2f cm, TTC: %.2f s, Behaviour: %s, Speed: %.1f cm/s, Yaw: %.2f rad/s, Plan: %lu us\n",
+                   robot.range.range_cm, robot.brake.ttc_s, arbiter.winner ? arbiter.winner : "none",
+                   arbiter.output.linear_cm_s, arbiter.output.angular_rad_s, (unsigned long)robot.plan_us);
         }
+        sleep_until(next_step);
     }
 
     return 0;
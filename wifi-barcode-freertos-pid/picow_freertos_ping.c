@@ -16,7 +16,7 @@
 #include "task.h"
 #include "ping.h"
 #include "lwip/apps/httpd.h"
-#include "hardware/adc.h"
+#include "adc_sampler.h"
 #include "message_buffer.h"
 
 #include "hardware/pwm.h"
@@ -123,14 +123,13 @@ u16_t ssi_handler(int iIndex, char *pcInsert, int iInsertLen)
     {
     case 0: // volt
     {
-        const float voltage = adc_read() * 3.3f / (1 << 12);
+        const float voltage = adc_sampler_volts(ADC_SAMPLER_TEMP);
         printed = snprintf(pcInsert, iInsertLen, "%f", voltage);
     }
     break;
     case 1: // temp
     {
-        const float voltage = adc_read() * 3.3f / (1 << 12);
-        const float tempC = 27.0f - (voltage - 0.706f) / 0.001721f;
+        const float tempC = adc_sampler_temperature_c();
         printed = snprintf(pcInsert, iInsertLen, "%f", tempC);
     }
     break;
@@ -163,10 +162,8 @@ u16_t ssi_handler(int iIndex, char *pcInsert, int iInsertLen)
 // Initialise the SSI handler
 void ssi_init()
 {
-    // Initialise ADC (internal pin)
-    adc_init();
-    adc_set_temp_sensor_enabled(true);
-    adc_select_input(4);
+    // Sample the ADC in the background, the handler only reads the latest values
+    adc_sampler_start();
 
     http_set_ssi_handler(ssi_handler, ssi_tags, LWIP_ARRAYSIZE(ssi_tags));
 }
@@ -471,7 +468,6 @@ void main_task(__unused void *params)
 
 void init_pins()
 {
-    adc_init();
     gpio_init(RIGHT_PWM);
     gpio_init(LEFT_PWM);
     gpio_init(RIGHT_BACKWARD);
@@ -531,10 +527,6 @@ void initWifi(__unused void *params)
     cgi_init();
     printf("CGI Handler initialised\n");
 
-    // Set the ADC channel for the IR sensor pin
-    adc_gpio_init(IR_SENSOR_PIN);
-    adc_select_input(0); // Use ADC channel 0 (pin 26)
-
     gpio_init(IR_SENSOR_PIN);
     gpio_set_dir(IR_SENSOR_PIN, GPIO_IN);
     gpio_set_irq_enabled_with_callback(IR_SENSOR_PIN, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, &handle_notch);
@@ -646,7 +638,6 @@ void vLaunch(void)
 int main(void)
 {
     stdio_init_all();
-    adc_init();
     init_pins();
 
     /* Configure the hardware ready to run the demo. */